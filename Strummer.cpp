@@ -46,13 +46,41 @@ SOFTWARE.
 #include <distingnt/api.h>
 #include <cmath>
 #include <cstring>
+// STRUMMER_NO_SIMD forces the scalar kernels (tests/ checks they match the SIMD ones)
+#if defined(__SSE2__) && !defined(STRUMMER_NO_SIMD)
+#define STRUMMER_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && !defined(STRUMMER_NO_SIMD)
+#define STRUMMER_NEON 1
+#include <arm_neon.h>
+#endif
+#if defined(STRUMMER_PROFILE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
 
 // --- Constants ---
 #define NUM_STANDARD_SCALES 16
 #define NUM_EXOTIC_SCALES 117
 #define NUM_SCALES (NUM_STANDARD_SCALES + NUM_EXOTIC_SCALES)
 #define SCALE_MAX_LEN 20 // Maximum number of notes in a scale
-#define SAMPLE_RATE 44100
+#define MAX_VOICES 8 // Poly voices, each driving a pitch and an envelope/gate bus
+#define NUM_BUSSES 28 // Busses available to the algorithm
+#define CH_UP 0 // Envelope channel of Trig Up (TUp Out / GateUP_Out)
+#define CH_DOWN 1 // Envelope channel of Trig Down (TDown Out / GateDN_Out)
+#define CH_VOICE 2 // First poly voice channel
+#define NUM_CHANNELS (CH_VOICE + MAX_VOICES)
+#define NUM_CHANNELS_PADDED ((NUM_CHANNELS + 3) & ~3) // Whole groups of 4 SIMD lanes
+#define ENV_CURVE_SIZE 256 // Segments in the Simple/Classic Exp envelope curve table
+#define MAX_LANES 4 // Independent strum lanes per instance (set by the "Lanes" specification)
+#define MAX_STRUMS 4 // Overlapping strums per lane (queue capacity)
+#define MAX_MIDI_NOTES 16 // Sounding MIDI notes tracked per lane
+#define MAX_MIDI_EVENTS 64 // MIDI messages collected per block
+#define MIDI_EVENT_SLOTS (MAX_MIDI_EVENTS + MAX_LANES * MAX_MIDI_NOTES) // Plus a Note Off for every tracked note
+#define MAX_USER_SCALES 16 // Scala tunings imported per instance (appended to the Scale enum)
+#define USER_SCALE_NAME_LEN 24
+#define VIEW_TOP 12        // First screen row of the string view (the host draws above it)
+#define VIEW_LANES_TOP 24  // First row of the lane bands, below the scale name
+#define SCREEN_ROW_BYTES 128 // 256 pixels at 4 bits
 
 // --- Parameter enum for clarity ---
 enum {
@@ -75,31 +103,267 @@ enum {
     kParamGateLen,      //Gate length (ms)
     kParamGateUPOut,   // New: GateUP_Out
     kParamGateDNOut,   // New: GateDN_Out
-    kNumParams         // last parameter
+    kParamVoices,      // Poly voices that let strings ring (0 = mono)
+    kParamVoiceOut,    // Output: first of the consecutive voice busses
+    kParamVoiceEnv,    // Second bus of each voice: envelope or gate
+    kParamSpacingCV,   // Input: Spacing modulation (1V/oct, +1V halves the spacing)
+    kParamTransposeCV, // Input: Transpose modulation (1V/oct, quantised to semitones)
+    kParamStringsCV,   // Input: Strings modulation (one string per semitone)
+    kParamScaleCV,     // Input: Scale modulation (one scale per semitone)
+    kParamCVRate,      // Rate at which the CV inputs are sampled
+    kParamRootCV,      // Input: quantizer mode, strings play scale degrees from this pitch
+    kParamChord,       // Chord voicing played across the strings (0 = scale order)
+    kParamMaxStrums,   // Strums that may overlap in a lane (1 = a trigger cuts off the last one)
+    kParamThreshold,   // Trigger input threshold (V)
+    kParamHysteresis,  // A high trigger input falls below Threshold minus this (V)
+    kParamTiming,      // 0 = strums on the sample grid, 1 = sub-sample trigger timing
+    kParamSpacingMode, // 0 = Spacing ms, 1..3 = fit the strum to the Trig Up/Down/any clock period
+    kParamStrumFill,   // Clock modes: part of the clock period the whole strum takes (%)
+    kParamMidiChannel, // MIDI channel of the string notes (0 = MIDI off)
+    kParamMidiDest,    // Where the MIDI notes go
+    kParamVelocity,    // Note velocity: trigger envelope, per-string curve or fixed
+    kParamStrumShape,  // Per-string timing and level: even, accelerando, ritardando or human
+    kParamShapeDepth,  // How strongly the strum shape bends timing and level (%)
+    kParamShapeSeed,   // Seed of the human shape
+    kNumParams         // last parameter (lanes 2.. follow, kNumLaneParams each)
 };
 
+// --- Routing parameters of one lane ---
+// Lane 1 uses the original parameters above; every further lane appends its own block.
+enum {
+    kLaneGateUp,
+    kLaneGateDown,
+    kLaneOutputPitch,
+    kLaneTUpOut,
+    kLaneTDownOut,
+    kLaneGateUPOut,
+    kLaneGateDNOut,
+    kLaneVoiceOut,
+    kNumLaneParams
+};
+
+static const uint8_t lane1Params[kNumLaneParams] = {
+    kParamGateUp, kParamGateDown, kParamOutputPitch, kParamTUpOut,
+    kParamTDownOut, kParamGateUPOut, kParamGateDNOut, kParamVoiceOut
+};
+
+static inline int laneParam(int lane, int which) {
+    return (lane == 0) ? lane1Params[which] : kNumParams + (lane - 1) * kNumLaneParams + which;
+}
+
 // --- State struct (holds persistent state for each instance) ---
 struct GateEnvelope {
-    enum Stage { Off, Attack, Decay, Sustain, Release } stage = Off;
-    float value = 0.0f;
-    int counter = 0;
+    enum Stage { Off, Attack, Decay, Sustain, Release }; // Envelope state lives in EnvelopeBank
 };
 
-struct StrumState {
-    int stepIndex = -1;         // Current step in the sequence
+// --- Block-rate parameter snapshot ---
+// Envelope and timing parameters resolved into per-sample terms by parameterChanged().
+// step() copies it once per block, so the sample loop never touches alg->v[].
+struct EnvCoeffs {
+    float attackInc = 2.0f;    // Added per sample in Attack (>= 1 for a zero-time stage)
+    float decayDec = 2.0f;     // Removed per sample in Decay
+    float releaseDec = 2.0f;   // Removed per sample in Release
+    float sustain = 1.0f;      // Sustain level (0..1)
+    int shape = 0;             // 0 = linear, 1 = simple exp, 2 = classic exp
+    const float* curve = NULL; // StrumState::envCurve, used by the exp shapes
+};
+
+struct BlockParams {
+    EnvCoeffs env;
+    float spacingSamples = 0.0f; // Samples between strings (fractional, carried over)
+    int gateLenSamples = 0;      // Length of the GateUP/GateDN pulses, rounded to a sample
+    int cvInterval = 0;          // Samples between CV reads (0 = once per block)
+    int maxStrums = 1;           // Strum queue capacity in use (1..MAX_STRUMS)
+    float riseThreshold = 1.0f;  // A low trigger input goes high above this
+    float fallThreshold = 1.0f;  // A high trigger input goes low at or below this
+    bool subSample = false;      // Strums start at the interpolated threshold crossing
+    float fireAt = 0.0f;         // A string fires once its countdown is at or below this
+    int clockSource = 0;         // Bit 0: Trig Up edges clock the spacing, bit 1: Trig Down
+    float clockTimeout = 0.0f;   // Longest clock period measured (samples); longer gaps restart it
+    uint8_t midiStatus = 0;      // Note On status byte of the MIDI channel (0 = MIDI off)
+    uint32_t midiDest = 0;       // kNT_destination flags
+    int velocityMode = 0;        // 0 = envelope, 1 = per-string curve, 2 = fixed
+    float cvSmooth = 1.0f;       // One-pole coefficient applied to Spacing CV at each read
+    bool voiceGates = false;     // Voices output gates instead of envelopes
+};
+
+// --- Envelope channels (structure-of-arrays, one SIMD lane per channel) ---
+// Channels CH_UP/CH_DOWN follow the Trig Up/Down inputs; channel CH_VOICE + v is poly voice v.
+// Every channel has an ADSR and a gate countdown: the GateUP/GateDN pulses for the trigger
+// channels, the voice gate (which also drives the voice ADSR) for the voices.
+struct EnvelopeBank {
+    alignas(16) float value[NUM_CHANNELS_PADDED] = {};     // Linear envelope level (0..1)
+    alignas(16) GateEnvelope::Stage stage[NUM_CHANNELS_PADDED] = {};
+    alignas(16) int pulse[NUM_CHANNELS_PADDED] = {};       // Remaining gate samples
+    alignas(16) float level[NUM_CHANNELS_PADDED] = {};     // Output volts at full level (5V x string gain)
+};
+
+// --- Poly voices ---
+// Voice v plays every string s with s % count == v, and keeps ringing until that string comes
+// round again. Voice v writes its pitch to bus VoiceOut + 2v and its envelope/gate to the next bus.
+struct VoiceBank {
+    float pitch[MAX_VOICES] = {};                 // Pitch of the voice's last string (V)
+};
+
+// --- One strum in progress ---
+struct Strum {
+    int stepIndex = 0;          // Next string to play
     int stepInc = 1;            // Direction: 1 for up, -1 for down
-    int msCounter = 0;          // Countdown for note spacing
+    float msCounter = 0.0f;     // Samples until the next string (keeps the fractional remainder)
+};
+
+// --- Per-lane state (one independent strum channel) ---
+// Strums are queued oldest first. A trigger appends one, stealing the oldest when the queue
+// is full; a strum leaves the queue once it has played its last string.
+struct StrumLane {
+    Strum strums[MAX_STRUMS];
+    int strumCount = 0;
     float lastGateUp = 0.0f;    // Last value of Trig Up input (for edge detection)
     float lastGateDown = 0.0f;  // Last value of Trig Down input (for edge detection)
+    bool levelUp = false;       // Trig Up gate level after threshold and hysteresis
+    bool levelDown = false;     // Trig Down gate level after threshold and hysteresis
+    int8_t lastString = -1;     // Last string played, for the display
+    int8_t lastDirection = 0;
+    float clockElapsed = -1.0f; // Samples since the last clock edge (-1 = none yet)
+    float clockLate = 0.0f;     // Sub-sample lateness of that edge
+    float clockPeriod = 0.0f;   // Smoothed clock period in samples (0 = not measured yet)
     float currentPitch = 0.0f;  // Holds the current pitch to output
-    int tUpPulse = 0;      // <-- add this
-    int tDownPulse = 0;    // <-- add this
-    GateEnvelope tUpEnv;
-    GateEnvelope tDownEnv;
+    EnvelopeBank channels;      // Trig Up/Down and voice envelopes and gates
+    VoiceBank voices;
+    int voiceCount = 0;         // Poly voices that fit on the busses after Voice Out (0 = mono)
+};
+
+// --- CV modulation, sampled at the CV rate ---
+// The quantised offsets are added to their parameters whenever the pitch table is built.
+struct ModState {
+    float spacingCV = 0.0f;     // Smoothed Spacing CV (V)
+    float spacingScale = 1.0f;  // exp2(-spacingCV), applied to BlockParams::spacingSamples
+    int transposeCV = 0;        // Semitones added to Transpose
+    int stringsCV = 0;          // Strings added to Strings
+    int scaleCV = 0;            // Scales added to Scale
+    int rootDegree = 0;         // Root CV quantised to a scale degree (degreeCount per octave)
 };
 
+struct VoicingCache;            // Chord voicings of the selected scale, see "Chord voicings"
+
+// --- MIDI output ---
+// String hits become Note On messages, collected with their frame in a per-block batch and sent
+// in frame order at the end of step() (the send call has no timestamp). Each sounding note is
+// tracked per lane until its Note Off, Gate Len later, which joins the batch of the block it
+// falls in.
+struct MidiEvent {
+    int frame;                  // Frame in the block (orders the batch)
+    uint8_t status, data1, data2;
+};
+
+struct MidiNote {
+    uint8_t status;             // Note On status byte it was started with (channel for the Note Off)
+    uint8_t note;
+    int remaining;              // Samples left, counted from the start of the current block
+};
+
+struct MidiOut {
+    MidiEvent events[MIDI_EVENT_SLOTS];
+    int eventCount = 0;
+    MidiNote notes[MAX_LANES][MAX_MIDI_NOTES];
+    int noteCount[MAX_LANES] = {};
+    uint8_t velCurve[SCALE_MAX_LEN] = {}; // Per-string velocity: the first string of a strum is the loudest
+};
+
+// --- What the display shows, published by step() once per block ---
+// Region 0 is the scale name, region 1 + l the strings of lane l. step() bumps a region's
+// version when its values change; draw() redraws a region only when its version moved on, and
+// otherwise restores it from the cached pixels. Each counter has a single writer per side, so
+// no locking is needed between the audio and UI threads.
+struct LaneView {
+    int8_t string = -1;         // Last string played (-1 = none yet)
+    int8_t direction = 0;       // 1 = up, -1 = down
+    uint8_t levelUp = 0;        // TUp/TDown envelope levels, 0..15
+    uint8_t levelDown = 0;
+};
+
+struct DisplayFeed {
+    volatile uint8_t version[1 + MAX_LANES] = {}; // Written by step()
+    int scale = -1;
+    int strings = 0;
+    LaneView lanes[MAX_LANES];
+    uint8_t drawn[1 + MAX_LANES] = {};            // Written by draw()
+    bool cached = false;
+    uint8_t pixels[(64 - VIEW_TOP) * SCREEN_ROW_BYTES] = {}; // The view as last drawn
+};
+
+struct UserScales;              // Imported Scala tunings, see "Scala import"
+
+// --- Strum shape tables ---
+// Indexed by a string's position in its strum (0 = first string played): time[k] scales the
+// gap after string k, gain[k] its voice envelope and MIDI velocity. The gaps average 1, so a
+// shaped strum takes as long as an even one. Rebuilt when a shape parameter or the string
+// count changes; step() only indexes them.
+struct StrumShape {
+    int type = 0;               // 0 = even, 1 = accelerando, 2 = ritardando, 3 = human
+    int depth = 0;              // %
+    int seed = 0;
+    int strings = 0;            // String count the tables were built for (0 = not built)
+    float time[SCALE_MAX_LEN] = {};
+    float gain[SCALE_MAX_LEN] = {};
+};
+
+// --- Shared state (scale, envelope and timing tables used by every lane) ---
+struct StrumState {
+    // Rotated scale pitch of every string position (before transpose), and the same plus
+    // transpose. Both cover SCALE_MAX_LEN strings, so a Strings change only moves pitchCount.
+    // Rebuilt from parameterChanged() and CV changes, step() only reads pitchTable.
+    float pitchBase[SCALE_MAX_LEN] = {};
+    float pitchTable[SCALE_MAX_LEN] = {};
+    int pitchCount = 0;         // Number of valid entries (0 = no valid scale)
+    ModState mod;
+    // Degrees of the current scale within one octave (volts) and the upper decision boundary
+    // of each, halfway to the next degree. Rebuilt with the scale, searched by the Root CV.
+    float degreeVolts[SCALE_MAX_LEN] = {};
+    float degreeBound[SCALE_MAX_LEN] = {};
+    int degreeCount = 1;
+    StrumShape shape;
+    float scaleRoot = 0.0f;        // Pitch of the scale's first note (0 except for .kbm tunings)
+    UserScales* userScales = NULL; // In DRAM
+    DisplayFeed* display = NULL;   // In DRAM
+    VoicingCache* voicings = NULL; // In DRAM, see "Memory placement"
+    MidiOut* midi = NULL;          // In DRAM, see "Memory placement"
+    // Clock modes: string spacing as a fraction of the clock period, per string count, so a
+    // strum of n strings spans Strum Fill of the period. Rebuilt when Strum Fill changes.
+    float clockRatio[SCALE_MAX_LEN + 1] = {};
+    BlockParams params;         // Rebuilt from parameterChanged(), copied once per block
+    uint32_t sampleRate = 0;    // Host rate params was built for (rebuilt when it changes)
+    // Simple/Classic Exp curve sampled at ENV_CURVE_SIZE + 1 points (plus one guard entry).
+    // Rebuilt when Env Shape or Env Exponent changes.
+    float envCurve[ENV_CURVE_SIZE + 2] = {};
+    int numLanes = 1;
+    StrumLane* lanes = NULL;    // numLanes lanes, stored contiguously after the shared state
+};
+
+// Lanes start on a 16-byte boundary after the shared state (EnvelopeBank is SIMD aligned)
+#define LANES_OFFSET ((sizeof(StrumState) + 15) & ~(size_t)15)
+// The MIDI state follows the voicing cache in DRAM
+#define MIDI_OFFSET ((sizeof(VoicingCache) + 15) & ~(size_t)15)
+// Then the imported Scala tunings
+#define USER_OFFSET (MIDI_OFFSET + ((sizeof(MidiOut) + 15) & ~(size_t)15))
+// And the display feed with its pixel cache
+#define DISPLAY_OFFSET (USER_OFFSET + ((sizeof(UserScales) + 15) & ~(size_t)15))
+
+// --- Memory placement ---
+// StrumState and its lanes are all touched by step() every block (counters, envelope banks,
+// pitch table, curve, block parameters), so they live in DTC. The scale catalogue and the
+// parameter tables are const and stay in flash. The voicing cache, only read on a chord or
+// degree change, the MIDI batch, only touched when a string fires, the imported Scala
+// tunings with the parameter table that names them, and the display feed go to DRAM.
+// DTC is shared by every loaded algorithm, so the per-instance footprint is capped here;
+// raise a budget only on purpose.
+#define STATE_DTC_BUDGET 1808 // Bytes of shared state per instance
+#define LANE_DTC_BUDGET 320   // Bytes per lane
+static_assert(sizeof(StrumState) <= STATE_DTC_BUDGET, "shared state outgrew its DTC budget");
+static_assert(sizeof(StrumLane) <= LANE_DTC_BUDGET, "lane state outgrew its DTC budget");
+
 // --- All scale names (standard + exotic) ---
-static const char* all_scale_names[NUM_SCALES] = {
+static const char* all_scale_names[] = {
     // Standard scales
     "Major", "Minor", "Harmonic Minor", "Melodic Minor", "Mixolydian", "Dorian", "Lydian", "Phrygian",
     "Aeolian", "Locrian", "Maj Pent", "Min Pent", "Whole Tone", "Octatonic HW", "Octatonic WH", "Ionian",
@@ -119,293 +383,419 @@ static const char* all_scale_names[NUM_SCALES] = {
     "32-16SD2", "30-15SD2", "28-14SD2", "26-13SD2", "24-12SD2", "22-11SD2", "20-10SD2", "18-9SD2", "16-8SD2", "14-7SD2", "12-6SD2", "10-5SD2", "8-4SD2",
     "BP Equal", "BP Just", "BP Lambda",
     "8-24HD3", "7-21HD3", "6-18HD3", "5-15HD3", "4-12HD3", "24-8HD3", "21-7HD3", "18-6HD3", "15-5HD3", "12-4HD3"
-    // Add more names if you have more exotic scales, up to NUM_EXOTIC_SCALES
 };
 
-// --- Exotic scale intervals (static, truncated for brevity) ---
-
-static const float exotic_scales[NUM_EXOTIC_SCALES][SCALE_MAX_LEN] = {
-
-
-   // Blues major (From midipal/BitT source code)
-    { 0.0f, 3.0f, 4.0f, 7.0f, 9.0f, 10.0f },
+// --- Scale catalogue ---
+// Every scale (standard + exotic) as semitone offsets from the root, packed back to back
+// in the order of all_scale_names. scale_lengths[] holds the note count of each row, so
+// 0.0 entries are never mistaken for the end of a scale. Only used at compile time to
+// generate scale_catalogue below, so it never ends up in the plugin image.
+static constexpr float scale_semitones[] = {
+    // --- Standard scales ---
+    0.0f, 2.0f, 4.0f, 5.0f, 7.0f, 9.0f, 11.0f, 12.0f,   // Major
+    0.0f, 2.0f, 3.0f, 5.0f, 7.0f, 8.0f, 10.0f, 12.0f,   // Minor
+    0.0f, 2.0f, 3.0f, 5.0f, 7.0f, 8.0f, 11.0f, 12.0f,   // Harmonic Minor
+    0.0f, 2.0f, 3.0f, 5.0f, 7.0f, 9.0f, 11.0f, 12.0f,   // Melodic Minor
+    0.0f, 2.0f, 4.0f, 5.0f, 7.0f, 9.0f, 10.0f, 12.0f,   // Mixolydian
+    0.0f, 2.0f, 3.0f, 5.0f, 7.0f, 9.0f, 10.0f, 12.0f,   // Dorian
+    0.0f, 2.0f, 4.0f, 6.0f, 7.0f, 9.0f, 11.0f, 12.0f,   // Lydian
+    0.0f, 1.0f, 3.0f, 5.0f, 7.0f, 8.0f, 10.0f, 12.0f,   // Phrygian
+    0.0f, 2.0f, 3.0f, 5.0f, 7.0f, 8.0f, 10.0f, 12.0f,   // Aeolian
+    0.0f, 1.0f, 3.0f, 5.0f, 6.0f, 8.0f, 10.0f, 12.0f,   // Locrian
+    0.0f, 2.0f, 4.0f, 7.0f, 9.0f,   // Maj Pent
+    0.0f, 3.0f, 5.0f, 7.0f, 10.0f,   // Min Pent
+    0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f,   // Whole Tone
+    0.0f, 1.0f, 3.0f, 4.0f, 6.0f, 7.0f, 9.0f, 10.0f,   // Octatonic HW
+    0.0f, 2.0f, 3.0f, 5.0f, 6.0f, 8.0f, 9.0f, 11.0f,   // Octatonic WH
+    0.0f, 2.0f, 4.0f, 5.0f, 7.0f, 9.0f, 11.0f, 12.0f,   // Ionian
+
+    // --- Exotic scales ---
+    // Blues major (From midipal/BitT source code)
+    0.0f, 3.0f, 4.0f, 7.0f, 9.0f, 10.0f,
     // Blues minor (From midipal/BitT source code)
-    { 0.0f, 3.0f, 5.0f, 6.0f, 7.0f, 10.0f },
+    0.0f, 3.0f, 5.0f, 6.0f, 7.0f, 10.0f,
 
     // Folk (From midipal/BitT source code)
-    { 0.0f, 1.0f, 3.0f, 4.0f, 5.0f, 7.0f, 8.0f, 10.0f },
+    0.0f, 1.0f, 3.0f, 4.0f, 5.0f, 7.0f, 8.0f, 10.0f,
     // Japanese (From midipal/BitT source code)
-    { 0.0f, 1.0f, 5.0f, 7.0f, 8.0f },
+    0.0f, 1.0f, 5.0f, 7.0f, 8.0f,
     // Gamelan (From midipal/BitT source code)
-    { 0.0f, 1.0f, 3.0f, 7.0f, 8.0f },
+    0.0f, 1.0f, 3.0f, 7.0f, 8.0f,
     // Gypsy
-    { 0.0f, 2.0f, 3.0f, 6.0f, 7.0f, 8.0f, 11.0f },
+    0.0f, 2.0f, 3.0f, 6.0f, 7.0f, 8.0f, 11.0f,
     // Arabian
-    { 0.0f, 1.0f, 4.0f, 5.0f, 7.0f, 8.0f, 11.0f },
+    0.0f, 1.0f, 4.0f, 5.0f, 7.0f, 8.0f, 11.0f,
     // Flamenco
-    { 0.0f, 1.0f, 4.0f, 5.0f, 7.0f, 8.0f, 10.0f },
+    0.0f, 1.0f, 4.0f, 5.0f, 7.0f, 8.0f, 10.0f,
     // Whole tone (From midipal/BitT source code)
-    { 0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f },
+    0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f,
     // pythagorean (From yarns source code)
-    { 0.0f, 0.898f, 2.039f, 2.938f, 4.078f, 4.977f, 6.117f, 7.023f, 7.922f, 9.062f, 9.961f, 11.102f },
+    0.0f, 0.898f, 2.039f, 2.938f, 4.078f, 4.977f, 6.117f, 7.023f, 7.922f, 9.062f, 9.961f, 11.102f,
     // 1_4_eb (From yarns source code)
-    { 0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 10.5f },
+    0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 10.5f,
     // 1_4_e (From yarns source code)
-    { 0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f },
+    0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f,
     // 1_4_ea (From yarns source code)
-    { 0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 8.5f, 10.0f, 11.0f },
+    0.0f, 1.0f, 2.0f, 3.0f, 3.5f, 5.0f, 6.0f, 7.0f, 8.0f, 8.5f, 10.0f, 11.0f,
     // bhairav (From yarns source code)
-    { 0.0f, 0.898f, 3.859f, 4.977f, 7.023f, 7.922f, 10.883f },
+    0.0f, 0.898f, 3.859f, 4.977f, 7.023f, 7.922f, 10.883f,
     // gunakri (From yarns source code)
-    { 0.0f, 1.117f, 4.977f, 7.023f, 8.141f },
+    0.0f, 1.117f, 4.977f, 7.023f, 8.141f,
     // marwa (From yarns source code)
-    { 0.0f, 1.117f, 3.859f, 5.898f, 8.844f, 10.883f },
+    0.0f, 1.117f, 3.859f, 5.898f, 8.844f, 10.883f,
     // shree (From yarns source code)
-    { 0.0f, 0.898f, 3.859f, 5.898f, 7.023f, 7.922f, 10.883f },
+    0.0f, 0.898f, 3.859f, 5.898f, 7.023f, 7.922f, 10.883f,
     // purvi (From yarns source code)
-    { 0.0f, 1.117f, 3.859f, 5.898f, 7.023f, 8.141f, 10.883f },
+    0.0f, 1.117f, 3.859f, 5.898f, 7.023f, 8.141f, 10.883f,
     // bilawal (From yarns source code)
-    { 0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 9.062f, 10.883f },
+    0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 9.062f, 10.883f,
     // yaman (From yarns source code)
-    { 0.0f, 2.039f, 4.078f, 6.117f, 7.023f, 9.062f, 11.102f },
+    0.0f, 2.039f, 4.078f, 6.117f, 7.023f, 9.062f, 11.102f,
     // kafi (From yarns source code)
-    { 0.0f, 1.820f, 2.938f, 4.977f, 7.023f, 8.844f, 9.961f },
+    0.0f, 1.820f, 2.938f, 4.977f, 7.023f, 8.844f, 9.961f,
     // bhimpalasree (From yarns source code)
-    { 0.0f, 2.039f, 3.156f, 4.977f, 7.023f, 9.062f, 10.180f },
+    0.0f, 2.039f, 3.156f, 4.977f, 7.023f, 9.062f, 10.180f,
     // darbari (From yarns source code)
-    { 0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 7.922f, 9.961f },
+    0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 7.922f, 9.961f,
     // rageshree (From yarns source code)
-    { 0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 8.844f, 9.961f },
+    0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 8.844f, 9.961f,
     // khamaj (From yarns source code)
-    { 0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 9.062f, 9.961f, 11.102f },
+    0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 9.062f, 9.961f, 11.102f,
     // mimal (From yarns source code)
-    { 0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 8.844f, 9.961f, 10.883f },
+    0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 8.844f, 9.961f, 10.883f,
     // parameshwari (From yarns source code)
-    { 0.0f, 0.898f, 2.938f, 4.977f, 8.844f, 9.961f },
+    0.0f, 0.898f, 2.938f, 4.977f, 8.844f, 9.961f,
     // rangeshwari (From yarns source code)
-    { 0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 10.883f },
+    0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 10.883f,
     // gangeshwari (From yarns source code)
-    { 0.0f, 3.859f, 4.977f, 7.023f, 7.922f, 9.961f },
+    0.0f, 3.859f, 4.977f, 7.023f, 7.922f, 9.961f,
     // kameshwari (From yarns source code)
-    { 0.0f, 2.039f, 5.898f, 7.023f, 8.844f, 9.961f },
+    0.0f, 2.039f, 5.898f, 7.023f, 8.844f, 9.961f,
     // pa__kafi (From yarns source code)
-    { 0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 9.062f, 9.961f },
+    0.0f, 2.039f, 2.938f, 4.977f, 7.023f, 9.062f, 9.961f,
     // natbhairav (From yarns source code)
-    { 0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 7.922f, 10.883f },
+    0.0f, 2.039f, 3.859f, 4.977f, 7.023f, 7.922f, 10.883f,
     // m_kauns (From yarns source code)
-    { 0.0f, 2.039f, 4.078f, 4.977f, 7.922f, 9.961f },
+    0.0f, 2.039f, 4.078f, 4.977f, 7.922f, 9.961f,
     // bairagi (From yarns source code)
-    { 0.0f, 0.898f, 4.977f, 7.023f, 9.961f },
+    0.0f, 0.898f, 4.977f, 7.023f, 9.961f,
     // b_todi (From yarns source code)
-    { 0.0f, 0.898f, 2.938f, 7.023f, 9.961f },
+    0.0f, 0.898f, 2.938f, 7.023f, 9.961f,
     // chandradeep (From yarns source code)
-    { 0.0f, 2.938f, 4.977f, 7.023f, 9.961f },
+    0.0f, 2.938f, 4.977f, 7.023f, 9.961f,
     // kaushik_todi (From yarns source code)
-    { 0.0f, 2.938f, 4.977f, 5.898f, 7.922f },
+    0.0f, 2.938f, 4.977f, 5.898f, 7.922f,
     // jogeshwari (From yarns source code)
-    { 0.0f, 2.938f, 3.859f, 4.977f, 8.844f, 9.961f },
+    0.0f, 2.938f, 3.859f, 4.977f, 8.844f, 9.961f,
 
     // Tartini-Vallotti [12]
-    { 0.0f, 0.9375f, 1.9609f, 2.9766f, 3.9219f, 5.0234f, 5.9219f, 6.9766f, 7.9609f, 8.9375f, 10.0f, 10.8984f },
+    0.0f, 0.9375f, 1.9609f, 2.9766f, 3.9219f, 5.0234f, 5.9219f, 6.9766f, 7.9609f, 8.9375f, 10.0f, 10.8984f,
     // 13 out of 22-tET, generator = 5 [13]
-    { 0.0f, 1.0938f, 2.1797f, 3.2734f, 3.8203f, 4.9063f, 6.0f, 6.5469f, 7.6328f, 8.7266f, 9.2734f, 10.3672f, 11.4531f },
+    0.0f, 1.0938f, 2.1797f, 3.2734f, 3.8203f, 4.9063f, 6.0f, 6.5469f, 7.6328f, 8.7266f, 9.2734f, 10.3672f, 11.4531f,
     // 13 out of 19-tET, Mandelbaum [13]
-    { 0.0f, 1.2656f, 1.8984f, 3.1563f, 3.7891f, 5.0547f, 5.6875f, 6.9453f, 7.5781f, 8.8438f, 9.4766f, 10.7344f, 11.3672f },
+    0.0f, 1.2656f, 1.8984f, 3.1563f, 3.7891f, 5.0547f, 5.6875f, 6.9453f, 7.5781f, 8.8438f, 9.4766f, 10.7344f, 11.3672f,
     // Magic[16] in 145-tET [16]
-    { 0.0f, 1.4922f, 2.0703f, 2.6484f, 3.2266f, 3.8047f, 4.3828f, 5.8750f, 6.4531f, 7.0313f, 7.6172f, 8.1953f, 9.6797f, 10.2656f, 10.8438f, 11.4219f },
+    0.0f, 1.4922f, 2.0703f, 2.6484f, 3.2266f, 3.8047f, 4.3828f, 5.8750f, 6.4531f, 7.0313f, 7.6172f, 8.1953f, 9.6797f, 10.2656f, 10.8438f, 11.4219f,
     // g=9 steps of 139-tET. Gene Ward Smith "Quartaminorthirds" 7-limit temperament [16]
-    { 0.0f, 0.7734f, 1.5547f, 2.3281f, 3.1094f, 3.8828f, 4.6641f, 5.4375f, 6.2188f, 6.9922f, 7.7734f, 8.5469f, 9.3203f, 10.1016f, 10.8750f, 11.6563f },
+    0.0f, 0.7734f, 1.5547f, 2.3281f, 3.1094f, 3.8828f, 4.6641f, 5.4375f, 6.2188f, 6.9922f, 7.7734f, 8.5469f, 9.3203f, 10.1016f, 10.8750f, 11.6563f,
     // Armodue semi-equalizzato [16]
-    { 0.0f, 0.7734f, 1.5469f, 2.3203f, 3.0938f, 3.8672f, 4.6484f, 5.4219f, 6.1953f, 6.9688f, 7.7422f, 8.5156f, 9.2891f, 9.6797f, 10.4531f, 11.2266f },
+    0.0f, 0.7734f, 1.5469f, 2.3203f, 3.0938f, 3.8672f, 4.6484f, 5.4219f, 6.1953f, 6.9688f, 7.7422f, 8.5156f, 9.2891f, 9.6797f, 10.4531f, 11.2266f,
 
     // Hirajoshi[5]
-    { 0.0f, 1.8516f, 3.3672f, 6.8281f, 7.8984f },
+    0.0f, 1.8516f, 3.3672f, 6.8281f, 7.8984f,
     // Scottish bagpipes[7]
-    { 0.0f, 1.9688f, 3.4063f, 4.9531f, 7.0313f, 8.5313f, 10.0938f },
+    0.0f, 1.9688f, 3.4063f, 4.9531f, 7.0313f, 8.5313f, 10.0938f,
     // Thai ranat[7]
-    { 0.0f, 1.6094f, 3.4609f, 5.2578f, 6.8594f, 8.6172f, 10.2891f },
+    0.0f, 1.6094f, 3.4609f, 5.2578f, 6.8594f, 8.6172f, 10.2891f,
 
     // Sevish quasi-12-equal mode from 31-EDO
-    { 0.0f, 1.1641f, 2.3203f, 3.0938f, 4.2578f, 5.0313f, 6.1953f, 7.3516f, 8.1328f, 9.2891f, 10.0625f, 11.2266f },
+    0.0f, 1.1641f, 2.3203f, 3.0938f, 4.2578f, 5.0313f, 6.1953f, 7.3516f, 8.1328f, 9.2891f, 10.0625f, 11.2266f,
     // 11 TET Machine[6]
-    { 0.0f, 2.1797f, 4.3672f, 5.4531f, 7.6328f, 9.8203f },
+    0.0f, 2.1797f, 4.3672f, 5.4531f, 7.6328f, 9.8203f,
     // 13 TET Father[8]
-    { 0.0f, 1.8438f, 3.6953f, 4.6172f, 6.4609f, 8.3047f, 9.2344f, 11.0781f },
+    0.0f, 1.8438f, 3.6953f, 4.6172f, 6.4609f, 8.3047f, 9.2344f, 11.0781f,
     // 15 TET Blackwood[10]
-    { 0.0f, 1.6016f, 2.3984f, 4.0f, 4.7969f, 6.3984f, 7.2031f, 8.7969f, 9.6016f, 11.2031f },
+    0.0f, 1.6016f, 2.3984f, 4.0f, 4.7969f, 6.3984f, 7.2031f, 8.7969f, 9.6016f, 11.2031f,
     // 16 TET Mavila[7]
-    { 0.0f, 1.5f, 3.0f, 5.25f, 6.75f, 8.25f, 9.75f },
+    0.0f, 1.5f, 3.0f, 5.25f, 6.75f, 8.25f, 9.75f,
     // 16 TET Mavila[9]
-    { 0.0f, 0.75f, 2.25f, 3.75f, 5.25f, 6.0f, 7.5f, 9.0f, 10.5f },
+    0.0f, 0.75f, 2.25f, 3.75f, 5.25f, 6.0f, 7.5f, 9.0f, 10.5f,
     // 17 TET Superpyth[12]
-    { 0.0f, 0.7031f, 1.4141f, 2.8203f, 3.5313f, 4.9375f, 5.6484f, 6.3516f, 7.7578f, 8.4688f, 9.8828f, 10.5859f },
+    0.0f, 0.7031f, 1.4141f, 2.8203f, 3.5313f, 4.9375f, 5.6484f, 6.3516f, 7.7578f, 8.4688f, 9.8828f, 10.5859f,
 
     // 22 TET Orwell[9]
-    { 0.0f, 1.0938f, 2.7266f, 3.8203f, 5.4531f, 6.5469f, 8.1797f, 9.2734f, 10.9063f },
+    0.0f, 1.0938f, 2.7266f, 3.8203f, 5.4531f, 6.5469f, 8.1797f, 9.2734f, 10.9063f,
     // 22 TET Pajara[10] Static Symmetrical Maj
-    { 0.0f, 1.0938f, 2.1797f, 3.8203f, 4.9063f, 6.0f, 7.0938f, 8.1797f, 9.8203f, 10.9063f },
+    0.0f, 1.0938f, 2.1797f, 3.8203f, 4.9063f, 6.0f, 7.0938f, 8.1797f, 9.8203f, 10.9063f,
     // 22 TET Pajara[10] Std Pentachordal Maj
-    { 0.0f, 1.0938f, 2.1797f, 3.8203f, 4.9063f, 6.0f, 7.0938f, 8.7266f, 9.8203f, 10.9063f },
+    0.0f, 1.0938f, 2.1797f, 3.8203f, 4.9063f, 6.0f, 7.0938f, 8.7266f, 9.8203f, 10.9063f,
     // 22 TET Porcupine[7]
-    { 0.0f, 1.6328f, 3.2734f, 4.9063f, 7.0938f, 8.7266f, 10.3672f },
+    0.0f, 1.6328f, 3.2734f, 4.9063f, 7.0938f, 8.7266f, 10.3672f,
     // 26 TET Flattone[12]
-    { 0.0f, 0.4609f, 1.8438f, 2.3047f, 3.6953f, 5.0781f, 5.5391f, 6.9219f, 7.3828f, 8.7656f, 9.2266f, 10.6172f },
+    0.0f, 0.4609f, 1.8438f, 2.3047f, 3.6953f, 5.0781f, 5.5391f, 6.9219f, 7.3828f, 8.7656f, 9.2266f, 10.6172f,
     // 26 TET Lemba[10]
-    { 0.0f, 1.3828f, 2.3047f, 3.6953f, 4.6172f, 6.0f, 7.3828f, 8.3047f, 9.6875f, 10.6172f },
+    0.0f, 1.3828f, 2.3047f, 3.6953f, 4.6172f, 6.0f, 7.3828f, 8.3047f, 9.6875f, 10.6172f,
     // 46 TET Sensi[11]
-    { 0.0f, 1.3047f, 2.6094f, 3.9141f, 4.4375f, 5.7422f, 7.0469f, 8.3516f, 8.8672f, 10.1719f, 11.4766f },
+    0.0f, 1.3047f, 2.6094f, 3.9141f, 4.4375f, 5.7422f, 7.0469f, 8.3516f, 8.8672f, 10.1719f, 11.4766f,
     // 53 TET Orwell[9]
-    { 0.0f, 1.1328f, 2.7188f, 3.8516f, 5.4375f, 6.5625f, 8.1484f, 9.2813f, 10.8672f },
+    0.0f, 1.1328f, 2.7188f, 3.8516f, 5.4375f, 6.5625f, 8.1484f, 9.2813f, 10.8672f,
     // 12 out of 72-TET scale by Prent Rodgers
-    { 0.0f, 2.0f, 2.6641f, 3.8359f, 4.3359f, 5.0f, 5.5f, 7.0f, 8.8359f, 9.6641f, 10.5f, 10.8359f },
+    0.0f, 2.0f, 2.6641f, 3.8359f, 4.3359f, 5.0f, 5.5f, 7.0f, 8.8359f, 9.6641f, 10.5f, 10.8359f,
     // Trivalent scale in zeus temperament[7]
-    { 0.0f, 1.5781f, 3.8750f, 5.4531f, 7.0313f, 9.3359f, 10.9063f },
+    0.0f, 1.5781f, 3.8750f, 5.4531f, 7.0313f, 9.3359f, 10.9063f,
     // 202 TET tempering of octone[8]
-    { 0.0f, 1.1875f, 3.5078f, 3.8594f, 6.1797f, 7.0078f, 9.3281f, 9.6797f },
+    0.0f, 1.1875f, 3.5078f, 3.8594f, 6.1797f, 7.0078f, 9.3281f, 9.6797f,
     // 313 TET elfmadagasgar[9]
-    { 0.0f, 2.0313f, 2.4922f, 4.5234f, 4.9844f, 7.0156f, 7.4766f, 9.5078f, 9.9688f },
+    0.0f, 2.0313f, 2.4922f, 4.5234f, 4.9844f, 7.0156f, 7.4766f, 9.5078f, 9.9688f,
     // Marvel woo version of glumma[12]
-    { 0.0f, 0.4922f, 2.3281f, 3.1719f, 3.8359f, 5.4922f, 6.1641f, 7.0078f, 8.8359f, 9.3281f, 9.6797f, 11.6563f },
+    0.0f, 0.4922f, 2.3281f, 3.1719f, 3.8359f, 5.4922f, 6.1641f, 7.0078f, 8.8359f, 9.3281f, 9.6797f, 11.6563f,
     // TOP Parapyth[12]
-    { 0.0f, 0.5859f, 2.0703f, 2.6563f, 4.1406f, 4.7266f, 5.5469f, 7.0469f, 7.6172f, 9.1094f, 9.6875f, 11.1797f },
+    0.0f, 0.5859f, 2.0703f, 2.6563f, 4.1406f, 4.7266f, 5.5469f, 7.0469f, 7.6172f, 9.1094f, 9.6875f, 11.1797f,
 
     // 16-ED (ED2 or ED3)
-    { 0.0f, 0.75f, 1.5f, 2.25f, 3.0f, 3.75f, 4.5f, 5.25f, 6.0f, 6.75f, 7.5f, 8.25f, 9.0f, 9.75f, 10.5f, 11.25f },
+    0.0f, 0.75f, 1.5f, 2.25f, 3.0f, 3.75f, 4.5f, 5.25f, 6.0f, 6.75f, 7.5f, 8.25f, 9.0f, 9.75f, 10.5f, 11.25f,
     // 15-ED (ED2 or ED3)
-    { 0.0f, 0.7969f, 1.6016f, 2.3984f, 3.2031f, 4.0f, 4.7969f, 5.6016f, 6.3984f, 7.2031f, 8.0f, 8.7969f, 9.6016f, 10.3984f, 11.2031f },
+    0.0f, 0.7969f, 1.6016f, 2.3984f, 3.2031f, 4.0f, 4.7969f, 5.6016f, 6.3984f, 7.2031f, 8.0f, 8.7969f, 9.6016f, 10.3984f, 11.2031f,
     // 14-ED (ED2 or ED3)
-    { 0.0f, 0.8594f, 1.7109f, 2.5703f, 3.4297f, 4.2891f, 5.1484f, 6.0f, 6.8594f, 7.7188f, 8.5781f, 9.4375f, 10.2969f, 11.1563f },
+    0.0f, 0.8594f, 1.7109f, 2.5703f, 3.4297f, 4.2891f, 5.1484f, 6.0f, 6.8594f, 7.7188f, 8.5781f, 9.4375f, 10.2969f, 11.1563f,
     // 13-ED (ED2 or ED3)
-    { 0.0f, 0.9219f, 1.8438f, 2.7656f, 3.6953f, 4.6328f, 5.6328f, 6.5703f, 7.4922f, 8.4141f, 9.3359f, 10.2578f, 11.1797f },
+    0.0f, 0.9219f, 1.8438f, 2.7656f, 3.6953f, 4.6328f, 5.6328f, 6.5703f, 7.4922f, 8.4141f, 9.3359f, 10.2578f, 11.1797f,
     // 11-ED (ED2 or ED3)
-    { 0.0f, 1.0938f, 2.1797f, 3.2734f, 4.3672f, 5.4531f, 6.5469f, 7.6328f, 8.7266f, 9.8203f, 10.9063f },
+    0.0f, 1.0938f, 2.1797f, 3.2734f, 4.3672f, 5.4531f, 6.5469f, 7.6328f, 8.7266f, 9.8203f, 10.9063f,
     // 10-ED (ED2 or ED3)
-    { 0.0f, 1.2031f, 2.3984f, 3.6016f, 4.7969f, 6.0f, 7.2031f, 8.3984f, 9.6016f, 10.7969f },
+    0.0f, 1.2031f, 2.3984f, 3.6016f, 4.7969f, 6.0f, 7.2031f, 8.3984f, 9.6016f, 10.7969f,
     // 9-ED (ED2 or ED3)
-    { 0.0f, 1.3359f, 2.6641f, 4.0f, 5.3359f, 6.6641f, 8.0f, 9.3359f, 10.6641f },
+    0.0f, 1.3359f, 2.6641f, 4.0f, 5.3359f, 6.6641f, 8.0f, 9.3359f, 10.6641f,
     // 8-ED (ED2 or ED3)
-    { 0.0f, 1.5f, 3.0f, 4.5f, 6.0f, 7.5f, 9.0f, 10.5f },
+    0.0f, 1.5f, 3.0f, 4.5f, 6.0f, 7.5f, 9.0f, 10.5f,
     // 7-ED (ED2 or ED3)
-    { 0.0f, 1.7109f, 3.4297f, 5.1484f, 6.8594f, 8.5781f, 10.2969f },
+    0.0f, 1.7109f, 3.4297f, 5.1484f, 6.8594f, 8.5781f, 10.2969f,
     // 6-ED (ED2 or ED3)
-    { 0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f },
+    0.0f, 2.0f, 4.0f, 6.0f, 8.0f, 10.0f,
     // 5-ED (ED2 or ED3)
-    { 0.0f, 2.3984f, 4.7969f, 7.2031f, 9.6016f },
+    0.0f, 2.3984f, 4.7969f, 7.2031f, 9.6016f,
 
     // 16-HD2 (16 step harmonic series scale on the octave)
-    { 0.0f, 1.0469f, 2.0391f, 2.9766f, 3.8594f, 4.7109f, 5.5156f, 6.2813f, 7.0234f, 7.7266f, 8.4063f, 9.0625f, 9.6875f, 10.2969f, 10.8906f, 11.4531f },
+    0.0f, 1.0469f, 2.0391f, 2.9766f, 3.8594f, 4.7109f, 5.5156f, 6.2813f, 7.0234f, 7.7266f, 8.4063f, 9.0625f, 9.6875f, 10.2969f, 10.8906f, 11.4531f,
     // 15-HD2 (15 step harmonic series scale on the octave)
-    { 0.0f, 1.1172f, 2.1641f, 3.1563f, 4.0938f, 4.9766f, 5.8203f, 6.6328f, 7.4141f, 8.1641f, 8.8828f, 9.5703f, 10.2266f, 10.852f, 11.4453f },
+    0.0f, 1.1172f, 2.1641f, 3.1563f, 4.0938f, 4.9766f, 5.8203f, 6.6328f, 7.4141f, 8.1641f, 8.8828f, 9.5703f, 10.2266f, 10.852f, 11.4453f,
     // 14-HD2 (14 step harmonic series scale on the octave)
-    { 0.0f, 1.1953f, 2.3125f, 3.3594f, 4.3516f, 5.2891f, 6.1797f, 7.0313f, 7.8516f, 8.6406f, 9.3984f, 10.125f, 10.8203f, 11.4844f },
+    0.0f, 1.1953f, 2.3125f, 3.3594f, 4.3516f, 5.2891f, 6.1797f, 7.0313f, 7.8516f, 8.6406f, 9.3984f, 10.125f, 10.8203f, 11.4844f,
     // 13-HD2 (13 step harmonic series scale on the octave)
-    { 0.0f, 1.2813f, 2.4766f, 3.5938f, 4.6406f, 5.6328f, 6.5703f, 7.4609f, 8.3125f, 9.125f, 9.9063f, 10.6484f, 11.3594f },
+    0.0f, 1.2813f, 2.4766f, 3.5938f, 4.6406f, 5.6328f, 6.5703f, 7.4609f, 8.3125f, 9.125f, 9.9063f, 10.6484f, 11.3594f,
     // 12-HD2 (12 step harmonic series scale on the octave)
-    { 0.0f, 1.3828f, 2.6719f, 3.8594f, 5.0078f, 6.0313f, 6.9922f, 7.9531f, 8.8438f, 9.6875f, 10.4844f, 11.2656f },
+    0.0f, 1.3828f, 2.6719f, 3.8594f, 5.0078f, 6.0313f, 6.9922f, 7.9531f, 8.8438f, 9.6875f, 10.4844f, 11.2656f,
     // 11-HD2 (11 step harmonic series scale on the octave)
-    { 0.0f, 1.5078f, 2.8906f, 4.1719f, 5.3672f, 6.4844f, 7.5391f, 8.5234f, 9.4688f, 10.3672f, 11.2109f },
+    0.0f, 1.5078f, 2.8906f, 4.1719f, 5.3672f, 6.4844f, 7.5391f, 8.5234f, 9.4688f, 10.3672f, 11.2109f,
     // 10-HD2 (10 step harmonic series scale on the octave)
-    { 0.0f, 1.6484f, 3.1563f, 4.5391f, 5.8672f, 7.0234f, 8.0703f, 9.1875f, 10.1797f, 11.1094f },
+    0.0f, 1.6484f, 3.1563f, 4.5391f, 5.8672f, 7.0234f, 8.0703f, 9.1875f, 10.1797f, 11.1094f,
     // 9-HD2 (9 step harmonic series scale on the octave)
-    { 0.0f, 1.8203f, 3.4766f, 5.0938f, 6.6797f, 8.2422f, 9.7891f, 11.3203f, 12.0f },
+    0.0f, 1.8203f, 3.4766f, 5.0938f, 6.6797f, 8.2422f, 9.7891f, 11.3203f, 12.0f,
     // 8-HD2 (8 step harmonic series scale on the octave)
-    { 0.0f, 2.0391f, 3.8594f, 5.5156f, 7.0234f, 8.4063f, 9.6875f, 10.8906f },
+    0.0f, 2.0391f, 3.8594f, 5.5156f, 7.0234f, 8.4063f, 9.6875f, 10.8906f,
     // 7-HD2 (7 step harmonic series scale on the octave)
-    { 0.0f, 2.3125f, 4.3516f, 6.1797f, 7.8516f, 9.3984f, 10.8203f },
+    0.0f, 2.3125f, 4.3516f, 6.1797f, 7.8516f, 9.3984f, 10.8203f,
     // 6-HD2 (6 step harmonic series scale on the octave)
-    { 0.0f, 3.0313f, 6.0313f, 9.0625f, 12.0f, 15.0f },
+    0.0f, 3.0313f, 6.0313f, 9.0625f, 12.0f, 15.0f,
     // 5-HD2 (5 step harmonic series scale on the octave)
-    { 0.0f, 4.0f, 8.0f, 12.0f, 16.0f },
+    0.0f, 4.0f, 8.0f, 12.0f, 16.0f,
 
     // 32-16-SD2 (16 step subharmonic series scale on the octave)
-    { 0.0f, 0.5469f, 1.1172f, 1.7031f, 2.3125f, 2.9375f, 3.5938f, 4.2734f, 4.9766f, 5.7188f, 6.4844f, 7.2891f, 8.0234f, 8.9297f, 9.9609f, 10.9531f },
+    0.0f, 0.5469f, 1.1172f, 1.7031f, 2.3125f, 2.9375f, 3.5938f, 4.2734f, 4.9766f, 5.7188f, 6.4844f, 7.2891f, 8.0234f, 8.9297f, 9.9609f, 10.9531f,
     // 30-15-SD2 (15 step subharmonic series scale on the octave)
-    { 0.0f, 0.5859f, 1.1953f, 1.8203f, 2.4766f, 3.1563f, 3.8594f, 4.6016f, 5.3672f, 6.1797f, 7.0313f, 7.9063f, 8.8438f, 9.8359f, 10.8828f },
+    0.0f, 0.5859f, 1.1953f, 1.8203f, 2.4766f, 3.1563f, 3.8594f, 4.6016f, 5.3672f, 6.1797f, 7.0313f, 7.9063f, 8.8438f, 9.8359f, 10.8828f,
     // 28-14-SD2 (14 step subharmonic series scale on the octave)
-    { 0.0f, 0.6328f, 1.2813f, 1.9609f, 2.6719f, 3.4063f, 4.1719f, 4.977f, 5.8203f, 6.6953f, 7.6328f, 8.6328f, 9.6875f, 10.8047f, 12.0f },
+    0.0f, 0.6328f, 1.2813f, 1.9609f, 2.6719f, 3.4063f, 4.1719f, 4.977f, 5.8203f, 6.6953f, 7.6328f, 8.6328f, 9.6875f, 10.8047f, 12.0f,
     // 26-13-SD2 (13 step subharmonic series scale on the octave)
-    { 0.0f, 0.6797f, 1.3828f, 2.125f, 2.8906f, 3.6953f, 4.5391f, 5.4219f, 6.3516f, 7.3203f, 8.3281f, 9.375f, 10.4609f },
+    0.0f, 0.6797f, 1.3828f, 2.125f, 2.8906f, 3.6953f, 4.5391f, 5.4219f, 6.3516f, 7.3203f, 8.3281f, 9.375f, 10.4609f,
     // 24-12-SD2 (12 step subharmonic series scale on the octave)
-    { 0.0f, 0.7344f, 1.5078f, 2.3125f, 3.1563f, 4.0469f, 4.9766f, 5.9531f, 6.9688f, 8.0234f, 9.1172f, 10.25f },
+    0.0f, 0.7344f, 1.5078f, 2.3125f, 3.1563f, 4.0469f, 4.9766f, 5.9531f, 6.9688f, 8.0234f, 9.1172f, 10.25f,
     // 22-11-SD2 (11 step subharmonic series scale on the octave)
-    { 0.0f, 0.8047f, 1.6484f, 2.5391f, 3.4766f, 4.4609f, 5.4922f, 6.5703f, 7.6953f, 8.8672f, 10.0859f },
+    0.0f, 0.8047f, 1.6484f, 2.5391f, 3.4766f, 4.4609f, 5.4922f, 6.5703f, 7.6953f, 8.8672f, 10.0859f,
     // 20-10-SD2 (10 step subharmonic series scale on the octave)
-    { 0.0f, 0.8906f, 1.8203f, 2.8125f, 3.8594f, 4.9609f, 6.1172f, 7.3281f, 8.5938f, 9.9141f },
+    0.0f, 0.8906f, 1.8203f, 2.8125f, 3.8594f, 4.9609f, 6.1172f, 7.3281f, 8.5938f, 9.9141f,
     // 18-9-SD2 (9 step subharmonic series scale on the octave)
-    { 0.0f, 0.9922f, 2.0391f, 3.1563f, 4.3359f, 5.5781f, 6.8828f, 8.25f, 9.6797f },
+    0.0f, 0.9922f, 2.0391f, 3.1563f, 4.3359f, 5.5781f, 6.8828f, 8.25f, 9.6797f,
     // 16-8-SD2 (8 step subharmonic series scale on the octave)
-    { 0.0f, 1.1172f, 2.3125f, 3.5938f, 4.9609f, 6.4141f, 7.9531f, 9.5781f },
+    0.0f, 1.1172f, 2.3125f, 3.5938f, 4.9609f, 6.4141f, 7.9531f, 9.5781f,
     // 14-7-SD2 (7 step subharmonic series scale on the octave)
-    { 0.0f, 1.2813f, 2.6719f, 4.1719f, 5.7891f, 7.5234f, 9.375f },
+    0.0f, 1.2813f, 2.6719f, 4.1719f, 5.7891f, 7.5234f, 9.375f,
     // 12-6-SD2 (6 step subharmonic series scale on the octave)
-    { 0.0f, 1.5078f, 3.1563f, 4.9609f, 6.9219f, 9.0391f },
+    0.0f, 1.5078f, 3.1563f, 4.9609f, 6.9219f, 9.0391f,
     // 10-5-SD2 (5 step subharmonic series scale on the octave)
-    { 0.0f, 1.8203f, 3.8594f, 6.1719f, 8.8438f },
+    0.0f, 1.8203f, 3.8594f, 6.1719f, 8.8438f,
     // 8-4-SD2 (4 step subharmonic series scale on the octave)
-    { 0.0f, 2.3125f, 4.9766f, 8.1406f },
+    0.0f, 2.3125f, 4.9766f, 8.1406f,
 
     // Bohlen-Pierce (equal)
-    { 0.0f, 0.9219f, 1.8438f, 2.7656f, 3.6953f, 4.6172f, 5.5391f, 6.4609f, 7.3828f, 8.3047f, 9.2344f, 10.1563f, 11.0781f },
+    0.0f, 0.9219f, 1.8438f, 2.7656f, 3.6953f, 4.6172f, 5.5391f, 6.4609f, 7.3828f, 8.3047f, 9.2344f, 10.1563f, 11.0781f,
     // Bohlen-Pierce (just)
-    { 0.0f, 0.8438f, 1.9063f, 2.7422f, 3.6719f, 4.6484f, 5.5781f, 6.4219f, 7.3516f, 8.3281f, 9.2578f, 10.0938f, 11.1563f },
+    0.0f, 0.8438f, 1.9063f, 2.7422f, 3.6719f, 4.6484f, 5.5781f, 6.4219f, 7.3516f, 8.3281f, 9.2578f, 10.0938f, 11.1563f,
     // Bohlen-Pierce (lambda)
-    { 0.0f, 1.9063f, 2.7422f, 3.6719f, 5.5781f, 6.4219f, 8.3281f, 9.2578f, 11.1563f },
+    0.0f, 1.9063f, 2.7422f, 3.6719f, 5.5781f, 6.4219f, 8.3281f, 9.2578f, 11.1563f,
 
     // 8-24-HD3 (16 step harmonic series scale on the tritave)
-    { 0.0f, 1.2891f, 2.4375f, 3.4766f, 4.4297f, 5.3047f, 6.1172f, 6.8828f, 7.6172f, 8.3203f, 9.0f, 9.6641f, 10.3125f, 10.9453f, 11.5625f, 12.1563f },
+    0.0f, 1.2891f, 2.4375f, 3.4766f, 4.4297f, 5.3047f, 6.1172f, 6.8828f, 7.6172f, 8.3203f, 9.0f, 9.6641f, 10.3125f, 10.9453f, 11.5625f, 12.1563f,
     // 7-21-HD3 (14 step harmonic series scale on the tritave)
-    { 0.0f, 1.4609f, 2.7422f, 3.8984f, 4.9375f, 5.8672f, 6.6953f, 7.4297f, 8.0781f, 8.6484f, 9.1484f, 9.5859f, 9.9688f, 10.3047f },
+    0.0f, 1.4609f, 2.7422f, 3.8984f, 4.9375f, 5.8672f, 6.6953f, 7.4297f, 8.0781f, 8.6484f, 9.1484f, 9.5859f, 9.9688f, 10.3047f,
     // 6-18-HD3 (12 step harmonic series scale on the tritave)
-    { 0.0f, 1.6875f, 3.1406f, 4.4297f, 5.5703f, 6.5703f, 7.4375f, 8.1797f, 8.8047f, 9.3203f, 9.7344f, 10.0547f },
+    0.0f, 1.6875f, 3.1406f, 4.4297f, 5.5703f, 6.5703f, 7.4375f, 8.1797f, 8.8047f, 9.3203f, 9.7344f, 10.0547f,
     // 5-15-HD3 (10 step harmonic series scale on the tritave)
-    { 0.0f, 1.9922f, 3.6719f, 5.1328f, 6.3828f, 7.4297f, 8.2813f, 8.9453f, 9.4297f, 9.7422f },
+    0.0f, 1.9922f, 3.6719f, 5.1328f, 6.3828f, 7.4297f, 8.2813f, 8.9453f, 9.4297f, 9.7422f,
     // 4-12-HD3 (8 step harmonic series scale on the tritave)
-    { 0.0f, 2.4375f, 4.4297f, 6.1172f, 7.6172f, 9.0f, 10.3125f, 11.5625f },
+    0.0f, 2.4375f, 4.4297f, 6.1172f, 7.6172f, 9.0f, 10.3125f, 11.5625f,
 
     // 24-8-HD3 (16 step subharmonic series scale on the tritave)
-    { 0.0f, 0.4688f, 0.9531f, 1.4609f, 1.9922f, 2.5469f, 3.125f, 3.7266f, 4.3516f, 5.0f, 5.6719f, 6.3672f, 7.0859f, 7.8281f, 8.5938f, 9.3828f },
+    0.0f, 0.4688f, 0.9531f, 1.4609f, 1.9922f, 2.5469f, 3.125f, 3.7266f, 4.3516f, 5.0f, 5.6719f, 6.3672f, 7.0859f, 7.8281f, 8.5938f, 9.3828f,
     // 21-7-HD3 (14 step subharmonic series scale on the tritave)
-    { 0.0f, 0.5313f, 1.0938f, 1.6875f, 2.3047f, 2.9453f, 3.6094f, 4.2969f, 5.0078f, 5.7422f, 6.5f, 7.2813f, 8.0859f, 8.9141f },
+    0.0f, 0.5313f, 1.0938f, 1.6875f, 2.3047f, 2.9453f, 3.6094f, 4.2969f, 5.0078f, 5.7422f, 6.5f, 7.2813f, 8.0859f, 8.9141f,
     // 18-6-HD3 (12 step subharmonic series scale on the tritave)
-    { 0.0f, 0.625f, 1.2891f, 1.9922f, 2.7344f, 3.5156f, 4.3359f, 5.1953f, 6.0938f, 7.0313f, 8.0078f, 9.0234f },
+    0.0f, 0.625f, 1.2891f, 1.9922f, 2.7344f, 3.5156f, 4.3359f, 5.1953f, 6.0938f, 7.0313f, 8.0078f, 9.0234f,
     // 15-5-HD3 (10 step subharmonic series scale on the tritave)
-    { 0.0f, 0.75f, 1.5625f, 2.4375f, 3.375f, 4.375f, 5.4375f, 6.5625f, 7.75f, 9.0f },
+    0.0f, 0.75f, 1.5625f, 2.4375f, 3.375f, 4.375f, 5.4375f, 6.5625f, 7.75f, 9.0f,
     // 12-4-HD3 (8 step subharmonic series scale on the tritave)
-    { 0.0f, 0.9531f, 1.9922f, 3.125f, 4.3516f, 5.6719f, 7.0859f, 8.5938f }
-};
-
-
-// --- Standard scale intervals (algorithmic) ---
-void get_standard_scale_intervals(int scaleIdx, int* out, int* outLen) {
-    // Fills out[] with scale intervals in semitones, sets outLen to number of notes
-    switch (scaleIdx) {
-        case 0: out[0]=0; out[1]=2; out[2]=4; out[3]=5; out[4]=7; out[5]=9; out[6]=11; out[7]=12; *outLen=8; break; // Major
-        case 1: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=7; out[5]=8; out[6]=10; out[7]=12; *outLen=8; break; // Minor
-        case 2: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=7; out[5]=8; out[6]=11; out[7]=12; *outLen=8; break; // Harmonic Minor
-        case 3: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=7; out[5]=9; out[6]=11; out[7]=12; *outLen=8; break; // Melodic Minor
-        case 4: out[0]=0; out[1]=2; out[2]=4; out[3]=5; out[4]=7; out[5]=9; out[6]=10; out[7]=12; *outLen=8; break; // Mixolydian
-        case 5: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=7; out[5]=9; out[6]=10; out[7]=12; *outLen=8; break; // Dorian
-        case 6: out[0]=0; out[1]=2; out[2]=4; out[3]=6; out[4]=7; out[5]=9; out[6]=11; out[7]=12; *outLen=8; break; // Lydian
-        case 7: out[0]=0; out[1]=1; out[2]=3; out[3]=5; out[4]=7; out[5]=8; out[6]=10; out[7]=12; *outLen=8; break; // Phrygian
-        case 8: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=7; out[5]=8; out[6]=10; out[7]=12; *outLen=8; break; // Aeolian
-        case 9: out[0]=0; out[1]=1; out[2]=3; out[3]=5; out[4]=6; out[5]=8; out[6]=10; out[7]=12; *outLen=8; break; // Locrian
-        case 10: out[0]=0; out[1]=2; out[2]=4; out[3]=7; out[4]=9; out[5]=12; out[6]=0; out[7]=0; *outLen=5; break; // Maj Pent
-        case 11: out[0]=0; out[1]=3; out[2]=5; out[3]=7; out[4]=10; out[5]=12; out[6]=0; out[7]=0; *outLen=5; break; // Min Pent
-        case 12: out[0]=0; out[1]=2; out[2]=4; out[3]=6; out[4]=8; out[5]=10; out[6]=12; out[7]=0; *outLen=7; break; // Whole Tone
-        case 13: out[0]=0; out[1]=1; out[2]=3; out[3]=4; out[4]=6; out[5]=7; out[6]=9; out[7]=10; *outLen=8; break; // Octatonic HW
-        case 14: out[0]=0; out[1]=2; out[2]=3; out[3]=5; out[4]=6; out[5]=8; out[6]=9; out[7]=11; *outLen=8; break; // Octatonic WH
-        case 15: out[0]=0; out[1]=2; out[2]=4; out[3]=5; out[4]=7; out[5]=9; out[6]=11; out[7]=12; *outLen=8; break; // Ionian
-        default: for (int i = 0; i < SCALE_MAX_LEN; ++i) out[i] = 0; *outLen = 0;
-    }
+    0.0f, 0.9531f, 1.9922f, 3.125f, 4.3516f, 5.6719f, 7.0859f, 8.5938f,
+};
+
+// Number of notes of each scale in scale_semitones, in all_scale_names order.
+static constexpr uint8_t scale_lengths[] = {
+    // Standard scales
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 5, 5, 7, 8, 8, 8,
+    // Exotic scales
+    6, 6, 8, 5, 5, 7, 7, 7, 6, 12, 12, 12, 12, 7, 5, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 6, 6, 6, 6, 7, 7,
+    6, 5, 5, 5, 5, 6, 12, 13, 13, 16, 16, 16, 5, 7, 7, 12,
+    6, 8, 10, 7, 9, 12, 9, 10, 10, 7, 12, 10, 11, 9, 12, 7,
+    8, 9, 12, 12, 16, 15, 14, 13, 11, 10, 9, 8, 7, 6, 5, 16,
+    15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 16, 15, 15, 13, 12,
+    11, 10, 9, 8, 7, 6, 5, 4, 13, 13, 9, 16, 14, 12, 10, 8,
+    16, 14, 12, 10, 8,
+};
+
+#define NUM_SCALE_NOTES (int)(sizeof(scale_semitones) / sizeof(scale_semitones[0]))
+
+// --- Compile-time index sequences (C++11 has no std::index_sequence) ---
+// Built by halving so the template depth stays logarithmic for the ~1200 note table.
+template <int... I> struct IndexSeq {};
+template <class A, class B> struct ConcatIndexSeq;
+template <int... A, int... B> struct ConcatIndexSeq<IndexSeq<A...>, IndexSeq<B...> > {
+    typedef IndexSeq<A..., (int)sizeof...(A) + B...> type;
+};
+template <int N> struct MakeIndexSeq
+    : ConcatIndexSeq<typename MakeIndexSeq<N / 2>::type, typename MakeIndexSeq<N - N / 2>::type> {};
+template <> struct MakeIndexSeq<0> { typedef IndexSeq<> type; };
+template <> struct MakeIndexSeq<1> { typedef IndexSeq<0> type; };
+
+// --- Catalogue consistency checks (evaluated by the compiler only) ---
+constexpr int scale_offset(int scale) {
+    return scale == 0 ? 0 : scale_offset(scale - 1) + scale_lengths[scale - 1];
+}
+constexpr bool scale_rows_valid(int scale) {
+    return scale == NUM_SCALES ||
+           (scale_lengths[scale] > 0 && scale_lengths[scale] <= SCALE_MAX_LEN &&
+            scale_semitones[scale_offset(scale)] == 0.0f && scale_rows_valid(scale + 1));
 }
 
+static_assert(sizeof(all_scale_names) / sizeof(all_scale_names[0]) == NUM_SCALES,
+              "all_scale_names must name every scale in the catalogue");
+static_assert(sizeof(scale_lengths) / sizeof(scale_lengths[0]) == NUM_SCALES,
+              "scale_lengths must have one entry per scale");
+static_assert(scale_offset(NUM_SCALES) == NUM_SCALE_NOTES,
+              "scale_lengths does not add up to the notes in scale_semitones");
+static_assert(scale_rows_valid(0),
+              "every scale needs 1..SCALE_MAX_LEN notes starting at 0.0");
+
+// --- Packed scale catalogue, pre-converted to volts (1V/octave) ---
+struct ScaleCatalogue {
+    float volts[NUM_SCALE_NOTES];   // All scales back to back
+    uint16_t offset[NUM_SCALES];    // First note of each scale in volts[]
+    uint8_t length[NUM_SCALES];     // Number of notes in each scale
+};
+
+template <int... N, int... S>
+constexpr ScaleCatalogue make_scale_catalogue(IndexSeq<N...>, IndexSeq<S...>) {
+    return ScaleCatalogue{ { (scale_semitones[N] / 12.0f)... },
+                           { (uint16_t)scale_offset(S)... },
+                           { scale_lengths[S]... } };
+}
+
+static constexpr ScaleCatalogue scale_catalogue =
+    make_scale_catalogue(MakeIndexSeq<NUM_SCALE_NOTES>::type(), MakeIndexSeq<NUM_SCALES>::type());
+
+// --- Chord voicings ---
+// Guitar-style voicing of every chord type on every degree of the Scale parameter's scale,
+// for all SCALE_MAX_LEN strings, so neither Strings, Mask Rotate nor a Chord change
+// invalidates it. volts[c - 1][d] is chord c with its root on degree d; other octaves add
+// whole volts. Built from parameterChanged() when Scale or the imported tunings change;
+// step() only reads it (with a chord selected, Scale CV is ignored).
+#define NUM_CHORDS 8            // Including Off
+struct VoicingCache {
+    int scale = -1;             // Scale the rows were built for (-1 = empty)
+    float volts[NUM_CHORDS - 1][SCALE_MAX_LEN][SCALE_MAX_LEN] = {}; // [chord - 1][root degree][string]
+};
+
+// --- DSP load instrumentation (build with -DSTRUMMER_PROFILE) ---
+// Cycles spent in step() per block, and the blocks that cost the most together with what was
+// active in them. Compiled out entirely otherwise: step() is the factory callback directly.
+#ifdef STRUMMER_PROFILE
+#ifndef PROFILE_CPU_HZ
+#define PROFILE_CPU_HZ 600000000 // Core clock, for the load figure
+#endif
+#define PROFILE_WORST 4              // Worst blocks kept
+
+struct ProfileBlock {
+    uint32_t cycles = 0;
+    uint16_t frames = 0;
+    uint8_t strums = 0;         // Strums queued, all lanes
+    uint8_t voices = 0;         // Voice envelopes not Off, all lanes
+    uint8_t midiNotes = 0;      // MIDI notes sounding
+    uint8_t cvRouted = 0;       // Any CV input routed
+};
+
+struct ProfileStats {
+    uint32_t blocks = 0;
+    uint32_t minCycles = 0xFFFFFFFFu;
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+    uint64_t totalFrames = 0;
+    ProfileBlock worst[PROFILE_WORST];  // Most expensive first
+};
+#endif
+
 // --- Algorithm struct (holds state pointer) ---
 struct _strumAlgorithm : public _NT_algorithm {
     StrumState* state;
+#ifdef STRUMMER_PROFILE
+    ProfileStats profile;
+#endif
+};
+
+// --- Specifications ---
+static const _NT_specification specifications[] = {
+    { .name = "Lanes", .min = 1, .max = MAX_LANES, .def = 1, .type = kNT_typeGeneric },
 };
 
 // --- Parameters array (controls and outputs) ---
 static const char* envShapeStrings[] = { "Linear", "Simple Exp", "Classic Exp", NULL };
+static const char* voiceEnvStrings[] = { "Envelope", "Gate", NULL };
+static const char* cvRateStrings[] = { "Block", "1 kHz", "4 kHz", NULL };
+static const char* timingStrings[] = { "Sample", "Sub-sample", NULL };
+static const char* spacingModeStrings[] = { "Free", "Clock Up", "Clock Down", "Clock Any", NULL };
+static const char* midiDestStrings[] = { "Breakout", "Select Bus", "USB", "Internal", "All", NULL };
+static const char* velocityStrings[] = { "Envelope", "Curve", "Fixed", NULL };
+static const char* strumShapeStrings[] = { "Even", "Accelerando", "Ritardando", "Human", NULL };
+static const char* chordStrings[] = { "Off", "Triad", "Seventh", "Sus2", "Sus4", "Power", "Sixth", "Add9", NULL };
+
+// Routing of lane n >= 2. Outputs other than the pitch default to 0 (not written).
+#define LANE_PARAMETERS(n) \
+    NT_PARAMETER_CV_INPUT(#n " Trig UP", 1, 2 * (n) - 1) \
+    NT_PARAMETER_CV_INPUT(#n " Trig Down", 1, 2 * (n)) \
+    NT_PARAMETER_CV_OUTPUT(#n " Strum Out", 1, 19 + (n)) \
+    NT_PARAMETER_CV_OUTPUT(#n " TUp Out", 0, 0) \
+    NT_PARAMETER_CV_OUTPUT(#n " TDown Out", 0, 0) \
+    NT_PARAMETER_CV_OUTPUT(#n " GateUP_Out", 0, 0) \
+    NT_PARAMETER_CV_OUTPUT(#n " GateDN_Out", 0, 0) \
+    NT_PARAMETER_CV_OUTPUT(#n " Voice Out", 0, 0)
 
 static const _NT_parameter parameters[] = {
     NT_PARAMETER_CV_INPUT("Trig UP", 1, 1)
@@ -429,190 +819,1579 @@ static const _NT_parameter parameters[] = {
     { .name = "Gate Len ms", .min = 1, .max = 30000, .def = 100, .unit = kNT_unitMs, .scaling = 0, .enumStrings = NULL },
     NT_PARAMETER_CV_OUTPUT("GateUP_Out", 1, 17)
     NT_PARAMETER_CV_OUTPUT("GateDN_Out", 1, 18)
-  
-    
+
+    { .name = "Voices", .min = 0, .max = MAX_VOICES, .def = 0, .unit = kNT_unitNone, .scaling = 0, .enumStrings = NULL },
+    NT_PARAMETER_CV_OUTPUT("Voice Out", 1, 19)
+    { .name = "Voice Env", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = voiceEnvStrings },
+
+    NT_PARAMETER_CV_INPUT("Spacing CV", 0, 0)
+    NT_PARAMETER_CV_INPUT("Transpose CV", 0, 0)
+    NT_PARAMETER_CV_INPUT("Strings CV", 0, 0)
+    NT_PARAMETER_CV_INPUT("Scale CV", 0, 0)
+    { .name = "CV Rate", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = cvRateStrings },
+    NT_PARAMETER_CV_INPUT("Root CV", 0, 0)
+    { .name = "Chord", .min = 0, .max = NUM_CHORDS - 1, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = chordStrings },
+    { .name = "Max Strums", .min = 1, .max = MAX_STRUMS, .def = 1, .unit = kNT_unitNone, .scaling = 0, .enumStrings = NULL },
+    { .name = "Threshold", .min = 1, .max = 100, .def = 10, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = NULL },
+    { .name = "Hysteresis", .min = 0, .max = 50, .def = 0, .unit = kNT_unitVolts, .scaling = kNT_scaling10, .enumStrings = NULL },
+    { .name = "Timing", .min = 0, .max = 1, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = timingStrings },
+    { .name = "Spacing Mode", .min = 0, .max = 3, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = spacingModeStrings },
+    { .name = "Strum Fill %", .min = 1, .max = 100, .def = 50, .unit = kNT_unitPercent, .scaling = 0, .enumStrings = NULL },
+    { .name = "MIDI Channel", .min = 0, .max = 16, .def = 0, .unit = kNT_unitNone, .scaling = 0, .enumStrings = NULL },
+    { .name = "MIDI Dest", .min = 0, .max = 4, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = midiDestStrings },
+    { .name = "Velocity", .min = 0, .max = 2, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = velocityStrings },
+    { .name = "Strum Shape", .min = 0, .max = 3, .def = 0, .unit = kNT_unitEnum, .scaling = 0, .enumStrings = strumShapeStrings },
+    { .name = "Shape Depth", .min = 0, .max = 100, .def = 50, .unit = kNT_unitPercent, .scaling = 0, .enumStrings = NULL },
+    { .name = "Shape Seed", .min = 0, .max = 999, .def = 1, .unit = kNT_unitNone, .scaling = 0, .enumStrings = NULL },
+
+    // Lanes 2.., only the first (Lanes - 1) blocks are exposed by calculateRequirements()
+    LANE_PARAMETERS(2)
+    LANE_PARAMETERS(3)
+    LANE_PARAMETERS(4)
 };
 
+#define NUM_ALL_PARAMS (sizeof(parameters) / sizeof(parameters[0]))
+static_assert(NUM_ALL_PARAMS == kNumParams + (MAX_LANES - 1) * kNumLaneParams,
+              "one LANE_PARAMETERS block per lane after the first");
+
+// --- Imported Scala tunings ---
+// Rows in the same form as the catalogue (ascending volts from 0, the period last), appended to
+// the Scale enum after the built-in scales. Each instance gets its own copy of the parameter
+// table so its Scale enum can grow. Filled by deserialise(), never touched by step().
+struct UserScales {
+    int count = 0;
+    char name[MAX_USER_SCALES][USER_SCALE_NAME_LEN] = {};
+    float volts[MAX_USER_SCALES][SCALE_MAX_LEN] = {};
+    uint8_t length[MAX_USER_SCALES] = {};
+    float root[MAX_USER_SCALES] = {};           // Pitch of the first note, from the .kbm reference
+    const char* scaleNames[NUM_SCALES + MAX_USER_SCALES + 1] = {}; // Scale enum strings
+    _NT_parameter paramTable[NUM_ALL_PARAMS];  // Per-instance copy of parameters[]
+};
+
+// --- Envelope curve shaping ---
+// The exp shapes read the precomputed curve with linear interpolation. With 256 segments
+// the result stays within 5e-4 of powf()/expf() (2.5 mV on the 5V outputs) for every
+// exponent; the worst case is Classic Exp at exponent 8, near zero.
+static inline float lookupCurve(const float* curve, float value) {
+    float pos = value * ENV_CURVE_SIZE; // value is always within 0..1
+    int idx = (int)pos;
+    float frac = pos - idx;
+    return curve[idx] + (curve[idx + 1] - curve[idx]) * frac;
+}
+
+static inline float shapeEnvelope(float value, const EnvCoeffs& c) {
+    return (c.shape == 0) ? value : lookupCurve(c.curve, value);
+}
+
 // --- Envelope processing function ---
-float processEnvelope(GateEnvelope& env, bool gate, float attack, float decay, float sustain, float release, int sampleRate, int envShape, float exponent) {
-    switch (env.stage) {
+// Advances an envelope by one sample and returns its shaped level (0..1).
+// Takes the stage and value separately so it serves both GateEnvelope and the voice arrays.
+float processEnvelope(GateEnvelope::Stage& stage, float& value, bool gate, const EnvCoeffs& c) {
+    switch (stage) {
         case GateEnvelope::Off:
-            if (gate) {
-                env.stage = GateEnvelope::Attack;
-                env.counter = 0;
-            }
-            env.value = 0.0f;
+            if (gate) stage = GateEnvelope::Attack;
+            value = 0.0f;
             break;
         case GateEnvelope::Attack:
-            env.value += 1.0f / (attack * sampleRate);
-            if (env.value >= 1.0f || attack == 0.0f) {
-                env.value = 1.0f;
-                env.stage = GateEnvelope::Decay;
+            value += c.attackInc;
+            if (value >= 1.0f) {
+                value = 1.0f;
+                stage = GateEnvelope::Decay;
             }
             break;
         case GateEnvelope::Decay:
-            env.value -= (1.0f - sustain) / (decay * sampleRate);
-            if (env.value <= sustain || decay == 0.0f) {
-                env.value = sustain;
-                env.stage = GateEnvelope::Sustain;
+            value -= c.decayDec;
+            if (value <= c.sustain) {
+                value = c.sustain;
+                stage = GateEnvelope::Sustain;
             }
             break;
         case GateEnvelope::Sustain:
-            if (!gate) env.stage = GateEnvelope::Release;
+            if (!gate) stage = GateEnvelope::Release;
             break;
         case GateEnvelope::Release:
-            env.value -= sustain / (release * sampleRate);
-            if (env.value <= 0.0f || release == 0.0f) {
-                env.value = 0.0f;
-                env.stage = GateEnvelope::Off;
+            value -= c.releaseDec;
+            if (value <= 0.0f) {
+                value = 0.0f;
+                stage = GateEnvelope::Off;
             }
             break;
     }
-    // --- Shape selection ---
-    switch (envShape) {
-        case 1: // Simple Exp
-            return powf(env.value, exponent);
-        case 2: { // Classic Exp
-            float k = exponent * 2.0f; // scale exponent for classic exp
-            return (1.0f - expf(-k * env.value)) / (1.0f - expf(-k));
+    return shapeEnvelope(value, c);
+}
+
+// --- Samples a ramp can run before it might reach its target ---
+// The running sum rounds by at most half an ulp of 1.0 (~3e-8) per add, so the step is padded
+// by 1e-7 and two samples are held back. Everything past this count goes through processEnvelope().
+static inline int safeRampSamples(float distance, float inc, int limit) {
+    float n = distance / (inc + 1.0e-7f) - 2.0f;
+    if (n <= 0.0f) return 0;
+    return (n < (float)limit) ? (int)n : limit;
+}
+
+// --- Samples until the envelope may change stage (0 = next sample is an event) ---
+int envelopeQuietSamples(GateEnvelope::Stage stage, float value, bool gate, const EnvCoeffs& c, int limit) {
+    switch (stage) {
+        case GateEnvelope::Off:     return gate ? 0 : limit;
+        case GateEnvelope::Sustain: return gate ? limit : 0;
+        case GateEnvelope::Attack:  return safeRampSamples(1.0f - value, c.attackInc, limit);
+        case GateEnvelope::Decay:   return safeRampSamples(value - c.sustain, c.decayDec, limit);
+        case GateEnvelope::Release: return safeRampSamples(value, c.releaseDec, limit);
+    }
+    return 0;
+}
+
+// --- Per-sample change of the envelope value during a quiet span ---
+static inline float envelopeDelta(GateEnvelope::Stage stage, const EnvCoeffs& c) {
+    switch (stage) {
+        case GateEnvelope::Attack:  return c.attackInc;
+        case GateEnvelope::Decay:   return -c.decayDec;
+        case GateEnvelope::Release: return -c.releaseDec;
+        default:                    return 0.0f; // Off or Sustain: constant level
+    }
+}
+
+// --- SIMD kernels ---
+// Quiet spans render four envelope channels at a time: one vector add per sample advances all
+// four ramps, and a 4x4 transpose turns every four samples into one 4-sample store per channel.
+// SSE is used on x86 builds and NEON where the target has it. The disting NT's Cortex-M7 has
+// no float SIMD and runs the scalar kernel. All three perform the same float operations in the
+// same order (curve lookups stay scalar), so their output is bit-identical.
+#if defined(STRUMMER_SSE)
+typedef __m128 lanes4;
+static inline lanes4 lanesLoad(const float* p) { return _mm_load_ps(p); }
+static inline void lanesStore(float* p, lanes4 v) { _mm_store_ps(p, v); }
+static inline void lanesStoreU(float* p, lanes4 v) { _mm_storeu_ps(p, v); }
+static inline lanes4 lanesSet(float x) { return _mm_set1_ps(x); }
+static inline lanes4 lanesAdd(lanes4 a, lanes4 b) { return _mm_add_ps(a, b); }
+static inline lanes4 lanesMul(lanes4 a, lanes4 b) { return _mm_mul_ps(a, b); }
+static inline void lanesTranspose(lanes4& r0, lanes4& r1, lanes4& r2, lanes4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#define STRUMMER_SIMD 1
+#elif defined(STRUMMER_NEON)
+typedef float32x4_t lanes4;
+static inline lanes4 lanesLoad(const float* p) { return vld1q_f32(p); }
+static inline void lanesStore(float* p, lanes4 v) { vst1q_f32(p, v); }
+static inline void lanesStoreU(float* p, lanes4 v) { vst1q_f32(p, v); }
+static inline lanes4 lanesSet(float x) { return vdupq_n_f32(x); }
+static inline lanes4 lanesAdd(lanes4 a, lanes4 b) { return vaddq_f32(a, b); }
+static inline lanes4 lanesMul(lanes4 a, lanes4 b) { return vmulq_f32(a, b); }
+static inline void lanesTranspose(lanes4& r0, lanes4& r1, lanes4& r2, lanes4& r3) {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+#define STRUMMER_SIMD 1
+#endif
+
+#ifdef STRUMMER_SIMD
+// Shaped output (volts) of four envelope values
+static inline lanes4 lanesShape(lanes4 v, const EnvCoeffs& c, lanes4 level) {
+    if (c.shape != 0) {
+        alignas(16) float x[4];
+        lanesStore(x, v);
+        for (int l = 0; l < 4; ++l) x[l] = lookupCurve(c.curve, x[l]);
+        v = lanesLoad(x);
+    }
+    return lanesMul(v, level);
+}
+#endif
+
+// --- Render n samples of four envelope channels (one group of lanes) ---
+// value/delta point at four consecutive channels; out[l] may be NULL for a channel whose
+// envelope is not routed (its delta is 0 then). Produces the same samples as n calls to
+// processEnvelope() per channel, as long as no channel changes stage within the span.
+static void renderEnvelopeLanes(float* value, const float* delta, const float* level, float* const* out, int n,
+                                const EnvCoeffs& c) {
+    int k = 0;
+#ifdef STRUMMER_SIMD
+    lanes4 v = lanesLoad(value);
+    lanes4 d = lanesLoad(delta);
+    lanes4 lv = lanesLoad(level);
+    for (; k + 4 <= n; k += 4) {
+        v = lanesAdd(v, d); lanes4 r0 = lanesShape(v, c, lv);
+        v = lanesAdd(v, d); lanes4 r1 = lanesShape(v, c, lv);
+        v = lanesAdd(v, d); lanes4 r2 = lanesShape(v, c, lv);
+        v = lanesAdd(v, d); lanes4 r3 = lanesShape(v, c, lv);
+        lanesTranspose(r0, r1, r2, r3);
+        if (out[0]) lanesStoreU(out[0] + k, r0);
+        if (out[1]) lanesStoreU(out[1] + k, r1);
+        if (out[2]) lanesStoreU(out[2] + k, r2);
+        if (out[3]) lanesStoreU(out[3] + k, r3);
+    }
+    lanesStore(value, v);
+#endif
+    // Scalar kernel (and SIMD tail)
+    for (; k < n; ++k) {
+        for (int l = 0; l < 4; ++l) {
+            value[l] += delta[l];
+            if (out[l]) out[l][k] = shapeEnvelope(value[l], c) * level[l];
         }
-        case 0: // Linear
-        default:
-            return env.value;
     }
 }
 
-// --- Main processing loop ---
-// This function is called for each audio block to process triggers and output the note sequence.
-void step(_NT_algorithm* self, float* busFrames, int numFramesBy4) {
-    _strumAlgorithm* alg = (_strumAlgorithm*)self;
-    StrumState* state = alg->state;
-    int numFrames = numFramesBy4 * 4;
+// --- Fill a span with a constant ---
+static inline void fillSpan(float* out, float level, int n) {
+    int k = 0;
+#ifdef STRUMMER_SIMD
+    lanes4 l4 = lanesSet(level);
+    for (; k + 4 <= n; k += 4) lanesStoreU(out + k, l4);
+#endif
+    for (; k < n; ++k) out[k] = level;
+}
 
-    // --- Read parameters ---
-    int scale = alg->v[kParamScale];
-    int spacingMs = alg->v[kParamSpacing];
-    int length = alg->v[kParamLength];
-    int transpose = alg->v[kParamTranspose];
-    int maskRotate = alg->v[kParamMaskRotate];
-    int gateLen = alg->v[kParamGateLen]; // in ms
-    int gateLenSamples = (SAMPLE_RATE * gateLen) / 1000;
+// --- Find the first frame where either trigger input changes level ---
+// Compares four frames of both inputs per iteration and returns the first frame whose level
+// differs from levelUp/levelDown, or limit if there is none. thrUp/thrDown are the thresholds
+// that apply in the current level (the fall threshold while high, the rise threshold while low).
+static int scanGateLevels(const float* up, const float* down, bool levelUp, bool levelDown,
+                          float thrUp, float thrDown, int limit) {
+    int j = 0;
+#if defined(STRUMMER_SSE)
+    __m128 tUp = _mm_set1_ps(thrUp);
+    __m128 tDown = _mm_set1_ps(thrDown);
+    int maskUp = levelUp ? 0xF : 0;
+    int maskDown = levelDown ? 0xF : 0;
+    for (; j + 4 <= limit; j += 4) {
+        int diff = (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(up + j), tUp)) ^ maskUp)
+                 | (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(down + j), tDown)) ^ maskDown);
+        if (diff) return j + __builtin_ctz(diff);
+    }
+#elif defined(STRUMMER_NEON)
+    float32x4_t tUp = vdupq_n_f32(thrUp);
+    float32x4_t tDown = vdupq_n_f32(thrDown);
+    uint32x4_t maskUp = vdupq_n_u32(levelUp ? 0xFFFFFFFFu : 0u);
+    uint32x4_t maskDown = vdupq_n_u32(levelDown ? 0xFFFFFFFFu : 0u);
+    for (; j + 4 <= limit; j += 4) {
+        uint32x4_t diff = vorrq_u32(veorq_u32(vcgtq_f32(vld1q_f32(up + j), tUp), maskUp),
+                                    veorq_u32(vcgtq_f32(vld1q_f32(down + j), tDown), maskDown));
+        uint32x2_t any = vorr_u32(vget_low_u32(diff), vget_high_u32(diff));
+        if (vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) break; // Resolved by the scalar loop
+    }
+#else
+    for (; j + 4 <= limit; j += 4) { // Unrolled: one branch per four frames
+        bool diff = ((up[j] > thrUp) != levelUp) | ((up[j + 1] > thrUp) != levelUp)
+                  | ((up[j + 2] > thrUp) != levelUp) | ((up[j + 3] > thrUp) != levelUp)
+                  | ((down[j] > thrDown) != levelDown) | ((down[j + 1] > thrDown) != levelDown)
+                  | ((down[j + 2] > thrDown) != levelDown) | ((down[j + 3] > thrDown) != levelDown);
+        if (diff) break;                 // Resolved by the scalar loop
+    }
+#endif
+    while (j < limit && (up[j] > thrUp) == levelUp && (down[j] > thrDown) == levelDown) ++j;
+    return j;
+}
 
-    // --- ADSR parameters ---
+// --- Render a span of a gate pulse countdown ---
+static inline void renderPulseSpan(int& pulse, float* out, int n) {
+    int on = (pulse < n) ? pulse : n;
+    fillSpan(out, 5.0f, on);
+    fillSpan(out + on, 0.0f, n - on);
+    pulse -= on;
+}
+
+// --- Per-block routing of the envelope channels ---
+struct ChannelOutputs {
+    int count;                                  // Channels in use (CH_VOICE + voices)
+    float* env[NUM_CHANNELS_PADDED];            // ADSR output bus, NULL if not routed
+    float* gate[NUM_CHANNELS_PADDED];           // Gate output bus, NULL if not routed
+};
+
+// --- Samples until any channel's envelope may change stage ---
+// levelUp/levelDown are the Trig Up/Down gate levels; the voices are gated by their countdown.
+int channelsQuietSamples(const EnvelopeBank& bank, const ChannelOutputs& co, bool levelUp, bool levelDown,
+                         const EnvCoeffs& c, int limit) {
+    limit = envelopeQuietSamples(bank.stage[CH_UP], bank.value[CH_UP], levelUp, c, limit);
+    if (limit > 0) limit = envelopeQuietSamples(bank.stage[CH_DOWN], bank.value[CH_DOWN], levelDown, c, limit);
+    for (int ch = CH_VOICE; ch < co.count && limit > 0; ++ch) {
+        if (!co.env[ch]) continue;               // Gate-only voice: countdown renders as a split fill
+        int pulse = bank.pulse[ch];
+        if (pulse > 0 && pulse < limit) limit = pulse;
+        limit = envelopeQuietSamples(bank.stage[ch], bank.value[ch], pulse > 0, c, limit);
+    }
+    return limit;
+}
+
+// --- Render a quiet span of every channel ---
+void renderChannelsSpan(EnvelopeBank& bank, const ChannelOutputs& co, const EnvCoeffs& c, int i, int n) {
+    alignas(16) float delta[NUM_CHANNELS_PADDED];
+    float* env[NUM_CHANNELS_PADDED];
+    int groups = (co.count + 3) >> 2;
+    for (int ch = 0; ch < groups * 4; ++ch) {
+        bool routed = ch < co.count && co.env[ch];
+        bool tracked = routed || ch < CH_VOICE;  // Trigger envelopes also feed the MIDI velocity
+        delta[ch] = tracked ? envelopeDelta(bank.stage[ch], c) : 0.0f;
+        env[ch] = routed ? co.env[ch] + i : NULL;
+    }
+    for (int g = 0; g < groups; ++g) {
+        const float* d = delta + 4 * g;
+        if (d[0] == 0.0f && d[1] == 0.0f && d[2] == 0.0f && d[3] == 0.0f) {
+            // Idle/sustaining group: every level is constant, so bulk-fill it
+            for (int ch = 4 * g; ch < 4 * g + 4; ++ch)
+                if (env[ch]) fillSpan(env[ch], shapeEnvelope(bank.value[ch], c) * bank.level[ch], n);
+            continue;
+        }
+        renderEnvelopeLanes(bank.value + 4 * g, d, bank.level + 4 * g, env + 4 * g, n, c);
+    }
+    for (int ch = 0; ch < co.count; ++ch) {
+        if (co.gate[ch]) {
+            renderPulseSpan(bank.pulse[ch], co.gate[ch] + i, n);
+        } else {
+            int& pulse = bank.pulse[ch];
+            pulse -= (pulse < n) ? pulse : n;
+        }
+    }
+}
+
+// --- Poly voice trigger ---
+// Starts voice v on a new string: takes the pitch and the string's gain, opens the gate and
+// re-attacks the envelope from its current level (an idle voice starts from zero, like the
+// trigger envelopes).
+static inline void triggerVoice(EnvelopeBank& bank, VoiceBank& vb, int v, float pitch, float gain, int gateLen) {
+    int ch = CH_VOICE + v;
+    vb.pitch[v] = pitch;
+    bank.level[ch] = 5.0f * gain;
+    bank.pulse[ch] = gateLen;
+    if (bank.stage[ch] != GateEnvelope::Off) bank.stage[ch] = GateEnvelope::Attack;
+}
+
+// --- Envelope curve rebuild ---
+// Samples the selected exp shape once, so the audio loop never calls powf()/expf().
+void buildEnvCurve(_strumAlgorithm* alg) {
+    float* curve = alg->state->envCurve;
+    int shape = alg->v[kParamEnvShape];
+    float exponent = alg->v[kParamEnvExponent] / 1.0f; // allow 1.00 to 8.00
+    float k = exponent * 2.0f;                         // scale exponent for classic exp
+    float norm = 1.0f - expf(-k);
+    for (int i = 0; i <= ENV_CURVE_SIZE; ++i) {
+        float x = (float)i / ENV_CURVE_SIZE;
+        switch (shape) {
+            case 1: curve[i] = powf(x, exponent); break;              // Simple Exp
+            case 2: curve[i] = (1.0f - expf(-k * x)) / norm; break;   // Classic Exp
+            default: curve[i] = x; break;                             // Linear
+        }
+    }
+    curve[ENV_CURVE_SIZE + 1] = curve[ENV_CURVE_SIZE]; // Guard for value == 1.0
+}
+
+// --- Block parameter rebuild ---
+// Converts the envelope, spacing and gate parameters into per-sample increments.
+void buildBlockParams(_strumAlgorithm* alg) {
+    BlockParams& bp = alg->state->params;
+    uint32_t sampleRate = NT_globals.sampleRate;
+    float rate = (float)sampleRate;
+    float samplesPerMs = rate / 1000.0f;
     float attack = alg->v[kParamAttack] / 1000.0f;   // ms to seconds
     float decay = alg->v[kParamDecay] / 1000.0f;
     float sustain = alg->v[kParamSustain] / 100.0f;  // percent to 0..1
     float release = alg->v[kParamRelease] / 1000.0f;
 
+    // A zero-time stage uses a step large enough to finish on its first sample
+    bp.env.attackInc = (attack > 0.0f) ? 1.0f / (attack * rate) : 2.0f;
+    bp.env.decayDec = (decay > 0.0f) ? (1.0f - sustain) / (decay * rate) : 2.0f;
+    bp.env.releaseDec = (release > 0.0f) ? sustain / (release * rate) : 2.0f;
+    bp.env.sustain = sustain;
+    bp.env.shape = alg->v[kParamEnvShape];
+    bp.env.curve = alg->state->envCurve;
+
+    bp.spacingSamples = alg->v[kParamSpacing] * samplesPerMs;
+    bp.gateLenSamples = (int)(alg->v[kParamGateLen] * samplesPerMs + 0.5f);
+    bp.maxStrums = alg->v[kParamMaxStrums];
+
+    // --- Trigger inputs ---
+    bp.riseThreshold = alg->v[kParamThreshold] / 10.0f;
+    bp.fallThreshold = bp.riseThreshold - alg->v[kParamHysteresis] / 10.0f;
+    bp.subSample = alg->v[kParamTiming] == 1;
+    bp.fireAt = bp.subSample ? 0.5f : 0.0f; // Sub-sample: fire on the frame nearest the exact time
+
+    // --- Clock-synced spacing ---
+    bp.clockSource = alg->v[kParamSpacingMode];
+    bp.clockTimeout = 4.0f * rate;
+    float fill = alg->v[kParamStrumFill] / 100.0f;
+    float* ratio = alg->state->clockRatio;
+    ratio[0] = ratio[1] = fill;                    // A single string has no gap to fill
+    for (int n = 2; n <= SCALE_MAX_LEN; ++n) ratio[n] = fill / (n - 1);
+
+    // --- MIDI ---
+    static const uint32_t midiDests[] = { kNT_destinationBreakout, kNT_destinationSelectBus, kNT_destinationUSB,
+                                          kNT_destinationInternal, kNT_destinationBreakout | kNT_destinationSelectBus |
+                                          kNT_destinationUSB | kNT_destinationInternal };
+    int channel = alg->v[kParamMidiChannel];
+    bp.midiStatus = channel ? (uint8_t)(0x90 | (channel - 1)) : 0;
+    bp.midiDest = midiDests[alg->v[kParamMidiDest]];
+    bp.velocityMode = alg->v[kParamVelocity];
+
+    // --- Poly voices of each lane, limited to the busses left after its Voice Out ---
+    for (int l = 0; l < alg->state->numLanes; ++l) {
+        int voiceOut = alg->v[laneParam(l, kLaneVoiceOut)];
+        int maxVoices = (voiceOut > 0) ? (NUM_BUSSES - voiceOut + 1) / 2 : 0; // 0 = not routed
+        alg->state->lanes[l].voiceCount = (alg->v[kParamVoices] < maxVoices) ? alg->v[kParamVoices] : maxVoices;
+    }
+    bp.voiceGates = alg->v[kParamVoiceEnv] == 1;
+
+    // --- CV sampling: Spacing CV settles with a ~5 ms time constant at any rate ---
+    static const int cvRateHz[] = { 0, 1000, 4000 };
+    int hz = cvRateHz[alg->v[kParamCVRate]];
+    bp.cvInterval = hz ? (int)(rate / hz + 0.5f) : 0;
+    int interval = bp.cvInterval ? bp.cvInterval : (int)NT_globals.maxFramesPerStep;
+    bp.cvSmooth = (interval > 0) ? 1.0f - expf(-interval / (0.005f * rate)) : 1.0f;
+    alg->state->sampleRate = sampleRate;
+}
+
+// --- Pitch table rebuild ---
+// Resolves scale and mask rotation into pitchBase[], transpose into pitchTable[] and the
+// string count into pitchCount. Each step only depends on the ones before it, so a CV change
+// redoes just its own step. Never called per sample.
+static inline int clampScale(const StrumState* state, int scale) {
+    // CV can push the scale past either end of the catalogue
+    int last = NUM_SCALES + state->userScales->count - 1;
+    return (scale < 0) ? 0 : (scale > last) ? last : scale;
+}
+
+// --- Notes of a built-in or imported scale ---
+static inline const float* scaleRow(const StrumState* state, int scale, int& length) {
+    if (scale >= NUM_SCALES) {
+        length = state->userScales->length[scale - NUM_SCALES];
+        return state->userScales->volts[scale - NUM_SCALES];
+    }
+    length = scale_catalogue.length[scale];
+    return scale_catalogue.volts + scale_catalogue.offset[scale];
+}
+
+// --- Degree index of a scale (quantizer mode) ---
+// The degrees are the scale entries below one octave; every catalogue row is ascending and
+// starts at 0, so they are already sorted.
+static void buildDegreeIndex(StrumState* state, int scale) {
+    scale = clampScale(state, scale);
+    int scaleLen;
+    const float* scaleVolts = scaleRow(state, scale, scaleLen);
+    state->scaleRoot = (scale >= NUM_SCALES) ? state->userScales->root[scale - NUM_SCALES] : 0.0f;
+    int count = 0;
+    while (count < scaleLen && scaleVolts[count] < 1.0f) {
+        state->degreeVolts[count] = scaleVolts[count];
+        ++count;
+    }
+    for (int d = 0; d < count; ++d) {
+        float next = (d + 1 < count) ? scaleVolts[d + 1] : 1.0f; // Root of the next octave
+        state->degreeBound[d] = 0.5f * (scaleVolts[d] + next);
+    }
+    state->degreeCount = count;
+}
+
+// --- Nearest scale degree to a pitch, counted from degree 0 at 0V ---
+static int quantiseDegree(const StrumState* state, float volts) {
+    float octave = floorf(volts);
+    float frac = volts - octave;
+    int lo = 0, hi = state->degreeCount;     // First boundary above frac
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (frac < state->degreeBound[mid]) hi = mid;
+        else lo = mid + 1;
+    }
+    return (int)octave * state->degreeCount + lo; // lo == degreeCount is the next octave's root
+}
+
+// --- Pitch of an absolute scale degree ---
+static inline int degreeOctave(int degree, int count) {
+    return (degree >= 0) ? degree / count : -((count - 1 - degree) / count); // Rounds down
+}
+
+static inline float degreePitch(const float* degreeVolts, int count, int degree) {
+    int octave = degreeOctave(degree, count);
+    return (float)octave + degreeVolts[degree - octave * count];
+}
+
+static inline float degreePitch(const StrumState* state, int degree) {
+    return degreePitch(state->degreeVolts, state->degreeCount, degree);
+}
+
+// --- Chord types, as scale degrees above the chord root ---
+struct ChordShape {
+    int count;
+    int degree[4];
+};
+
+static const ChordShape chordShapes[] = {
+    { 1, { 0 } },          // Off (unused)
+    { 3, { 0, 2, 4 } },    // Triad
+    { 4, { 0, 2, 4, 6 } }, // Seventh
+    { 3, { 0, 1, 4 } },    // Sus2
+    { 3, { 0, 3, 4 } },    // Sus4
+    { 2, { 0, 4 } },       // Power
+    { 4, { 0, 2, 4, 5 } }, // Sixth
+    { 4, { 0, 2, 4, 8 } }, // Add9
+};
+
+// --- Voicing cache rebuild ---
+// Each string takes the next chord tone at least a fourth above the previous one on the two
+// lowest intervals and a minor third above it after that, which gives the open E shape
+// (root, fifth, root, third, fifth, root) for a triad. Degrees are the scale entries below one
+// octave, as in buildDegreeIndex(). Never called from step().
+static void buildVoicings(StrumState* state, int scale) {
+    VoicingCache& vc = *state->voicings;
+    scale = clampScale(state, scale);
+    if (vc.scale == scale) return;
+    int scaleLen;
+    const float* degreeVolts = scaleRow(state, scale, scaleLen);
+    int count = 0;
+    while (count < scaleLen && degreeVolts[count] < 1.0f) ++count;
+    for (int chord = 1; chord < NUM_CHORDS; ++chord) {
+        const ChordShape& shape = chordShapes[chord];
+        for (int d = 0; d < count; ++d) {
+            float* row = vc.volts[chord - 1][d];
+            float prev = degreePitch(degreeVolts, count, d);
+            row[0] = prev;
+            int k = 0;                               // Chord tone index, counting up through octaves
+            for (int s = 1; s < SCALE_MAX_LEN; ++s) {
+                float gap = ((s < 3) ? 5.0f : 3.0f) / 12.0f - 1e-4f;
+                float pitch;
+                do {
+                    ++k;
+                    int tone = d + shape.degree[k % shape.count] + (k / shape.count) * count;
+                    pitch = degreePitch(degreeVolts, count, tone);
+                } while (pitch < prev + gap);
+                row[s] = prev = pitch;
+            }
+        }
+    }
+    vc.scale = scale;
+}
+
+// Scale mode steps through the catalogue row; quantizer mode (follow) counts scale degrees up
+// from the quantised Root CV, crossing octaves. With a chord selected, the strings play the
+// cached voicing on the root degree (Mask Rotate, plus the Root CV degree when following).
+static void buildPitchBase(StrumState* state, int scale, int maskRotate, bool follow, int chord) {
+    const VoicingCache& vc = *state->voicings;
+    if (chord > 0 && vc.scale == clampScale(state, scale)) { // Plain scale order until the voicings are built
+        int root = (follow ? state->mod.rootDegree : 0) + maskRotate;
+        int octave = degreeOctave(root, state->degreeCount);
+        const float* row = vc.volts[chord - 1][root - octave * state->degreeCount];
+        for (int i = 0; i < SCALE_MAX_LEN; ++i) state->pitchBase[i] = row[i] + (float)octave;
+        return;
+    }
+    if (follow) {
+        for (int i = 0; i < SCALE_MAX_LEN; ++i)
+            state->pitchBase[i] = degreePitch(state, state->mod.rootDegree + i + maskRotate);
+        return;
+    }
+
+    // --- Look up the scale in the packed catalogue ---
+    scale = clampScale(state, scale);
+    int scaleLen;
+    const float* scaleVolts = scaleRow(state, scale, scaleLen);
+
+    // --- Apply mask rotation, wrapping negative offsets too ---
+    // Intervals stay in float volts so microtonal and just scales keep their exact tuning.
+    for (int i = 0; i < SCALE_MAX_LEN; ++i) {
+        int idx = ((i + maskRotate) % scaleLen + scaleLen) % scaleLen;
+        state->pitchBase[i] = scaleVolts[idx];
+    }
+}
+
+static void applyTranspose(StrumState* state, int transpose) {
+    float transposeVolts = transpose / 12.0f + state->scaleRoot;
+    for (int i = 0; i < SCALE_MAX_LEN; ++i) state->pitchTable[i] = state->pitchBase[i] + transposeVolts;
+}
+
+// --- Strum shape table rebuild ---
+// Accelerando narrows the gaps linearly and swells towards the last string, ritardando the
+// reverse; human jitters both from a seeded generator. Never called per sample.
+static void buildStrumShape(StrumShape& shape, int strings) {
+    shape.strings = strings;
+    float depth = shape.depth * 0.01f;
+    int gaps = strings - 1;
+    uint32_t rng = 0x9E3779B9u * (uint32_t)(shape.seed + 1);
+    float total = 0.0f;
+    for (int k = 0; k < SCALE_MAX_LEN; ++k) {
+        float time = 1.0f, gain = 1.0f;
+        float ramp = (gaps > 1 && k < gaps) ? 1.0f - 2.0f * k / (gaps - 1) : 0.0f; // +1 .. -1 over the gaps
+        float along = (gaps > 0 && k < strings) ? (float)k / gaps : 1.0f;         // 0 .. 1 over the strings
+        switch (shape.type) {
+            case 1:
+                time = 1.0f + 0.9f * depth * ramp;
+                gain = 1.0f - 0.5f * depth * (1.0f - along);
+                break;
+            case 2:
+                time = 1.0f - 0.9f * depth * ramp;
+                gain = 1.0f - 0.5f * depth * along;
+                break;
+            case 3:
+                rng = rng * 1664525u + 1013904223u;
+                time = 1.0f + 0.5f * depth * ((rng >> 8) * (2.0f / 16777216.0f) - 1.0f);
+                rng = rng * 1664525u + 1013904223u;
+                gain = 1.0f - 0.3f * depth * ((rng >> 8) * (1.0f / 16777216.0f));
+                break;
+        }
+        shape.time[k] = time;
+        shape.gain[k] = gain;
+        if (k < gaps) total += time;
+    }
+    if (shape.type == 3 && gaps > 0)
+        for (int k = 0; k < gaps; ++k) shape.time[k] *= gaps / total; // Keep the strum length
+}
+
+static void applyStrings(StrumState* state, int length) {
     // --- Bounds check for sequence length ---
     if (length < 1) length = 1;
     if (length > SCALE_MAX_LEN) length = SCALE_MAX_LEN;
+    state->pitchCount = length;
+    if (state->shape.strings != length) buildStrumShape(state->shape, length);
+}
+
+void buildPitchTable(_strumAlgorithm* alg) {
+    StrumState* state = alg->state;
+    const ModState& mod = state->mod;
+    int chord = alg->v[kParamChord];
+    int scale = alg->v[kParamScale] + ((chord > 0) ? 0 : mod.scaleCV); // Chords ignore Scale CV
+    if (chord > 0) buildVoicings(state, scale); // No-op unless the scale changed
+    buildDegreeIndex(state, scale);
+    buildPitchBase(state, scale, alg->v[kParamMaskRotate], alg->v[kParamRootCV] != 0, chord);
+    applyTranspose(state, alg->v[kParamTranspose] + mod.transposeCV);
+    applyStrings(state, alg->v[kParamLength] + mod.stringsCV);
+}
 
-    // --- Prepare scale intervals ---
-    int intervals[SCALE_MAX_LEN];
-    int scaleIntervals[SCALE_MAX_LEN];
-    int scaleLen = 0;
-    if (scale < NUM_STANDARD_SCALES) {
-        get_standard_scale_intervals(scale, scaleIntervals, &scaleLen);
-    } else if (scale < NUM_SCALES) {
-        int exoticIdx = scale - NUM_STANDARD_SCALES;
-        scaleLen = 0;
-        for (int i = 0; i < SCALE_MAX_LEN; ++i) {
-            if (exotic_scales[exoticIdx][i] == 0 && i != 0) break;
-            scaleIntervals[scaleLen++] = (int)exotic_scales[exoticIdx][i];
+// --- Parameter change handler ---
+void parameterChanged(_NT_algorithm* self, int p) {
+    _strumAlgorithm* alg = (_strumAlgorithm*)self;
+    switch (p) {
+        case kParamScale:
+        case kParamLength:
+        case kParamTranspose:
+        case kParamMaskRotate:
+        case kParamChord:
+            buildPitchTable(alg);
+            break;
+        case kParamEnvShape:
+        case kParamEnvExponent:
+            buildEnvCurve(alg);
+            buildBlockParams(alg);
+            break;
+        case kParamSpacing:
+        case kParamAttack:
+        case kParamDecay:
+        case kParamSustain:
+        case kParamRelease:
+        case kParamGateLen:
+        case kParamVoices:
+        case kParamVoiceOut:
+        case kParamVoiceEnv:
+        case kParamCVRate:
+        case kParamMaxStrums:
+        case kParamThreshold:
+        case kParamHysteresis:
+        case kParamTiming:
+        case kParamSpacingMode:
+        case kParamStrumFill:
+        case kParamMidiChannel:
+        case kParamMidiDest:
+        case kParamVelocity:
+            buildBlockParams(alg);
+            break;
+        case kParamSpacingCV:
+        case kParamTransposeCV:
+        case kParamStringsCV:
+        case kParamScaleCV:
+        case kParamRootCV:
+            // Rerouted: drop the held offsets, step() samples the new bus
+            alg->state->mod = ModState{};
+            buildPitchTable(alg);
+            break;
+        case kParamStrumShape:
+        case kParamShapeDepth:
+        case kParamShapeSeed: {
+            StrumShape& shape = alg->state->shape;
+            shape.type = alg->v[kParamStrumShape];
+            shape.depth = alg->v[kParamShapeDepth];
+            shape.seed = alg->v[kParamShapeSeed];
+            buildStrumShape(shape, shape.strings ? shape.strings : SCALE_MAX_LEN);
+            break;
         }
+        default:
+            if (p >= kNumParams && (p - kNumParams) % kNumLaneParams == kLaneVoiceOut)
+                buildBlockParams(alg);
+            break;
     }
-    if (scaleLen == 0) return; // No valid scale
+}
 
-    // --- Apply mask rotation and fill intervals array ---
-    for (int i = 0; i < length; ++i) {
-        intervals[i] = scaleIntervals[(i + maskRotate + scaleLen) % scaleLen];
+// --- Bus of a routing parameter (NULL for an unrouted output) ---
+static inline float* laneBus(const _strumAlgorithm* alg, float* busFrames, int numFrames, int lane, int which) {
+    int bus = alg->v[laneParam(lane, which)];
+    return (bus > 0) ? busFrames + (bus - 1) * numFrames : NULL;
+}
+
+// --- Sample the CV inputs at one frame ---
+// Spacing is smoothed; Transpose, Strings and Scale are quantised to semitones and only touch
+// the pitch table when their step changes.
+static inline int quantiseCV(const float* bus, int frame) {
+    float cv = bus[frame];
+    if (cv < -10.0f) cv = -10.0f;
+    if (cv > 10.0f) cv = 10.0f;
+    return (int)floorf(cv * 12.0f + 0.5f);
+}
+
+static void sampleModulation(_strumAlgorithm* alg, float* busFrames, int numFrames, int frame) {
+    StrumState* state = alg->state;
+    ModState& mod = state->mod;
+    int spacingBus = alg->v[kParamSpacingCV];
+    int transposeBus = alg->v[kParamTransposeCV];
+    int stringsBus = alg->v[kParamStringsCV];
+    int scaleBus = alg->v[kParamScaleCV];
+    int rootBus = alg->v[kParamRootCV];
+
+    if (spacingBus) {
+        float cv = busFrames[(spacingBus - 1) * numFrames + frame];
+        if (cv < -5.0f) cv = -5.0f;
+        if (cv > 5.0f) cv = 5.0f;
+        mod.spacingCV += (cv - mod.spacingCV) * state->params.cvSmooth;
+        mod.spacingScale = exp2f(-mod.spacingCV);
     }
+    int scale = (scaleBus && alg->v[kParamChord] == 0) ? quantiseCV(busFrames + (scaleBus - 1) * numFrames, frame) : 0;
+    int transpose = transposeBus ? quantiseCV(busFrames + (transposeBus - 1) * numFrames, frame) : 0;
+    int strings = stringsBus ? quantiseCV(busFrames + (stringsBus - 1) * numFrames, frame) : 0;
+    bool rebuild = scale != mod.scaleCV;
+    if (rebuild) buildDegreeIndex(state, alg->v[kParamScale] + scale);
+    if (rootBus) {
+        float cv = busFrames[(rootBus - 1) * numFrames + frame];
+        if (cv < -10.0f) cv = -10.0f;
+        if (cv > 10.0f) cv = 10.0f;
+        int degree = quantiseDegree(state, cv);
+        rebuild = rebuild || degree != mod.rootDegree;
+        mod.rootDegree = degree;
+    }
+    if (rebuild) {
+        mod.scaleCV = scale;
+        mod.transposeCV = transpose;
+        buildPitchBase(state, alg->v[kParamScale] + scale, alg->v[kParamMaskRotate], rootBus != 0,
+                       alg->v[kParamChord]);
+        applyTranspose(state, alg->v[kParamTranspose] + transpose);
+    } else if (transpose != mod.transposeCV) {
+        mod.transposeCV = transpose;
+        applyTranspose(state, alg->v[kParamTranspose] + transpose);
+    }
+    if (strings != mod.stringsCV) {
+        mod.stringsCV = strings;
+        applyStrings(state, alg->v[kParamLength] + strings);
+    }
+}
+
+// --- Strum queue ---
+// Starts a strum at string index, stealing the oldest strums while the queue is full.
+// counter is the countdown of its first string (minus the trigger's lateness in sub-sample mode).
+static inline void startStrum(StrumLane& lane, int maxStrums, int index, int inc, float counter) {
+    while (lane.strumCount >= maxStrums) {
+        for (int k = 1; k < lane.strumCount; ++k) lane.strums[k - 1] = lane.strums[k];
+        --lane.strumCount;
+    }
+    Strum& s = lane.strums[lane.strumCount++];
+    s.stepIndex = index;
+    s.stepInc = inc;
+    s.msCounter = counter;
+}
+
+// --- Trigger lateness ---
+// Samples between the linearly interpolated threshold crossing and the frame the rising
+// edge was seen on (0..1]. A trigger without a crossing between the two frames (the input was
+// already above a threshold that was just lowered) counts as on time.
+static inline float edgeLateness(float prev, float in, float threshold) {
+    if (!(prev <= threshold && threshold < in)) return 0.0f;
+    float late = 1.0f - (threshold - prev) / (in - prev);
+    return (late < 0.0f) ? 0.0f : (late > 1.0f) ? 1.0f : late;
+}
+
+// Drops strums that have played their last string (or fell off a shortened string count).
+static inline void pruneStrums(StrumLane& lane, int length) {
+    int kept = 0;
+    for (int k = 0; k < lane.strumCount; ++k) {
+        const Strum& s = lane.strums[k];
+        if (s.stepIndex >= 0 && s.stepIndex < length) lane.strums[kept++] = s;
+    }
+    lane.strumCount = kept;
+}
+
+// --- Clock period estimator ---
+// Measures the time between clock edges (to sub-sample accuracy when the lateness is known) and
+// smooths it. A jump to more than double or less than half the estimate, such as a tempo switch
+// or a clock divider change, replaces the estimate; a gap over the timeout restarts measuring.
+static inline void clockAdvance(StrumLane& lane, float n, float timeout) {
+    if (lane.clockElapsed >= 0.0f && lane.clockElapsed <= timeout) lane.clockElapsed += n;
+}
+
+static inline void clockEdge(StrumLane& lane, float late, float timeout) {
+    float measured = lane.clockElapsed + lane.clockLate - late;
+    if (lane.clockElapsed >= 0.0f && measured > 0.0f && measured <= timeout) {
+        float period = lane.clockPeriod;
+        if (period <= 0.0f || measured > 2.0f * period || measured < 0.5f * period) lane.clockPeriod = measured;
+        else lane.clockPeriod = period + (measured - period) * 0.25f;
+    }
+    lane.clockElapsed = 0.0f;
+    lane.clockLate = late;
+}
+
+// --- MIDI batch ---
+static inline void midiQueue(MidiOut& midi, int frame, uint8_t status, uint8_t data1, uint8_t data2) {
+    if (midi.eventCount == MIDI_EVENT_SLOTS) return; // Callers check for room first
+    MidiEvent& e = midi.events[midi.eventCount++];
+    e.frame = frame;
+    e.status = status;
+    e.data1 = data1;
+    e.data2 = data2;
+}
+
+// Note On for a string hit at frame. A note that is still sounding in the lane is ended first
+// (at its own end if that was earlier in the block); when the lane is tracking MAX_MIDI_NOTES
+// notes the oldest one is ended to make room.
+static void midiNoteOn(MidiOut& midi, int lane, int frame, float pitch, int velocity, const BlockParams& bp) {
+    if (midi.eventCount > MAX_MIDI_EVENTS - 2) return; // No room for a Note Off and a Note On: drop the hit
+    int note = 60 + (int)floorf(pitch * 12.0f + 0.5f); // 0V = middle C
+    note = (note < 0) ? 0 : (note > 127) ? 127 : note;
+    MidiNote* notes = midi.notes[lane];
+    int& count = midi.noteCount[lane];
+    int k = 0;
+    while (k < count && notes[k].note != note) ++k;
+    if (k == count && count == MAX_MIDI_NOTES) k = 0;
+    if (k < count) {
+        int end = (notes[k].remaining < frame) ? notes[k].remaining : frame;
+        midiQueue(midi, end, (uint8_t)(notes[k].status - 0x10), notes[k].note, 0);
+        for (++k; k < count; ++k) notes[k - 1] = notes[k];
+        --count;
+    }
+    MidiNote& n = notes[count++];
+    n.status = bp.midiStatus;
+    n.note = (uint8_t)note;
+    n.remaining = frame + bp.gateLenSamples;
+    midiQueue(midi, frame, bp.midiStatus, (uint8_t)note, (uint8_t)velocity);
+}
+
+// --- Send the block's MIDI ---
+// Queues a Note Off for every note whose Gate Len runs out during the block, sorts the batch by
+// frame and sends it as one stream. The sort is stable, and on a shared frame Note Offs go first,
+// so a note ending there never cuts off one that starts there.
+static inline int midiOrder(const MidiEvent& e) {
+    return 2 * e.frame + ((e.status & 0xF0) == 0x90);
+}
+
+static void midiFlush(MidiOut& midi, int numLanes, int numFrames, uint32_t dest) {
+    for (int l = 0; l < numLanes; ++l) {
+        MidiNote* notes = midi.notes[l];
+        int kept = 0;
+        for (int k = 0; k < midi.noteCount[l]; ++k) {
+            if (notes[k].remaining < numFrames) {
+                midiQueue(midi, notes[k].remaining, (uint8_t)(notes[k].status - 0x10), notes[k].note, 0);
+            } else {
+                notes[k].remaining -= numFrames;
+                notes[kept++] = notes[k];
+            }
+        }
+        midi.noteCount[l] = kept;
+    }
+
+    MidiEvent* events = midi.events;
+    for (int a = 1; a < midi.eventCount; ++a) {
+        MidiEvent e = events[a];
+        int b = a;
+        for (; b > 0 && midiOrder(events[b - 1]) > midiOrder(e); --b) events[b] = events[b - 1];
+        events[b] = e;
+    }
+    for (int a = 0; a < midi.eventCount; ++a)
+        NT_sendMidi3ByteMessage(dest, events[a].status, events[a].data1, events[a].data2);
+    midi.eventCount = 0;
+}
+
+// --- Velocity of a string hit ---
+// Envelope: the level the trigger envelope (TUp/TDown) that started the strum reaches on this
+// frame with its gate held, so the strum follows its attack and decay and then stays at the
+// sustain level, even after a short trigger pulse has released the envelope. Strings fire
+// before the frame's envelope update, so the level is stepped ahead here.
+// Curve: falls off from the first string of the strum.
+static inline int stringVelocity(const BlockParams& bp, const EnvelopeBank& bank, const MidiOut& midi,
+                                 const Strum& s, int length, bool gate) {
+    switch (bp.velocityMode) {
+        case 0: {
+            const EnvCoeffs& c = bp.env;
+            int ch = (s.stepInc > 0) ? CH_UP : CH_DOWN;
+            float value = bank.value[ch];
+            switch (bank.stage[ch]) {
+                case GateEnvelope::Off: value = gate ? fminf(c.attackInc, 1.0f) : c.sustain; break;
+                case GateEnvelope::Attack: value = fminf(value + c.attackInc, 1.0f); break;
+                case GateEnvelope::Decay: value = fmaxf(value - c.decayDec, c.sustain); break;
+                default: value = c.sustain; break;
+            }
+            return 1 + (int)(shapeEnvelope(value, c) * 126.0f + 0.5f);
+        }
+        case 1: return midi.velCurve[(s.stepInc > 0) ? s.stepIndex : length - 1 - s.stepIndex];
+        default: return 100;
+    }
+}
+
+// --- Process one lane for frames [start, end) of a block ---
+// Lanes share the block parameters and the pitch table; everything else lives in StrumLane.
+static void stepLane(const _strumAlgorithm* alg, StrumLane& lane, int l, const BlockParams& bp,
+                     float* busFrames, int numFrames, int start, int end) {
+    const EnvCoeffs& env = bp.env;
+    const float* pitchTable = alg->state->pitchTable;
+    const StrumShape& shape = alg->state->shape;
+    int length = alg->state->pitchCount;
+    float clockRatio = alg->state->clockRatio[length];
 
     // --- Get pointers to input and output buffers ---
-    float* gateUp = busFrames + (alg->v[kParamGateUp] - 1) * numFrames;
-    float* gateDown = busFrames + (alg->v[kParamGateDown] - 1) * numFrames;
-    float* outPitch = busFrames + (alg->v[kParamOutputPitch] - 1) * numFrames;
-    float* tUpOut = busFrames + (alg->v[kParamTUpOut] - 1) * numFrames;
-    float* tDownOut = busFrames + (alg->v[kParamTDownOut] - 1) * numFrames;
-    float* gateUPOut = busFrames + (alg->v[kParamGateUPOut] - 1) * numFrames;
-    float* gateDNOut = busFrames + (alg->v[kParamGateDNOut] - 1) * numFrames;
-
-    // --- Main sample loop ---
-    for (int i = 0; i < numFrames; ++i) {
+    float* gateUp = laneBus(alg, busFrames, numFrames, l, kLaneGateUp);
+    float* gateDown = laneBus(alg, busFrames, numFrames, l, kLaneGateDown);
+    float* outPitch = laneBus(alg, busFrames, numFrames, l, kLaneOutputPitch);
+    float* tUpOut = laneBus(alg, busFrames, numFrames, l, kLaneTUpOut);
+    float* tDownOut = laneBus(alg, busFrames, numFrames, l, kLaneTDownOut);
+    float* gateUPOut = laneBus(alg, busFrames, numFrames, l, kLaneGateUPOut);
+    float* gateDNOut = laneBus(alg, busFrames, numFrames, l, kLaneGateDNOut);
+
+    // --- Envelope channel and poly voice busses ---
+    EnvelopeBank& bank = lane.channels;
+    VoiceBank& voices = lane.voices;
+    int voiceCount = lane.voiceCount;
+    ChannelOutputs co;
+    co.count = CH_VOICE + voiceCount;
+    co.env[CH_UP] = tUpOut;
+    co.env[CH_DOWN] = tDownOut;
+    co.gate[CH_UP] = gateUPOut;
+    co.gate[CH_DOWN] = gateDNOut;
+    float* voicePitchOut[MAX_VOICES];
+    for (int v = 0; v < voiceCount; ++v) {
+        // Pitch, then envelope or gate, for each voice
+        voicePitchOut[v] = laneBus(alg, busFrames, numFrames, l, kLaneVoiceOut) + 2 * v * numFrames;
+        float* second = voicePitchOut[v] + numFrames;
+        co.env[CH_VOICE + v] = bp.voiceGates ? NULL : second;
+        co.gate[CH_VOICE + v] = bp.voiceGates ? second : NULL;
+    }
+
+    // --- Main sample loop, one segment at a time ---
+    // A segment is either a quiet span, in which the gate inputs keep their level, no envelope
+    // changes stage and no new string is due, or a single event frame that runs the full
+    // per-sample logic. Quiet spans are rendered as plain ramps, constants and countdowns.
+    // Outputs are written in the same order as the event frame (envelopes, gates, pitches), so
+    // aliased busses behave the same.
+    int i = start;
+    while (i < end) {
+        bool levelUp = lane.levelUp;
+        bool levelDown = lane.levelDown;
+        float thrUp = levelUp ? bp.fallThreshold : bp.riseThreshold;
+        float thrDown = levelDown ? bp.fallThreshold : bp.riseThreshold;
+        pruneStrums(lane, length);
+        bool running = lane.strumCount > 0;
+
+        // --- Length of the quiet span starting at this frame ---
+        int limit = end - i;
+        for (int k = 0; k < lane.strumCount; ++k) {
+            // Frames before the next string is due (the counter is checked before it is decremented)
+            float counter = lane.strums[k].msCounter - bp.fireAt;
+            int due = (counter > 0.0f) ? (int)ceilf(counter) : 0;
+            if (due < limit) limit = due;
+        }
+        if (limit > 0) limit = channelsQuietSamples(bank, co, levelUp, levelDown, env, limit);
+        int n = (limit > 0) ? scanGateLevels(gateUp + i, gateDown + i, levelUp, levelDown, thrUp, thrDown, limit) : 0;
+#ifdef STRUMMER_NO_SPANS
+        n = 0;                  // Test builds: every frame takes the event path
+#endif
+
+        if (n > 0) {
+            float lastUp = gateUp[i + n - 1];
+            float lastDown = gateDown[i + n - 1];
+            renderChannelsSpan(bank, co, env, i, n);
+            if (outPitch) fillSpan(outPitch + i, running ? lane.currentPitch : 0.0f, n);
+            for (int v = 0; v < voiceCount; ++v) fillSpan(voicePitchOut[v] + i, voices.pitch[v], n);
+            for (int k = 0; k < lane.strumCount; ++k) lane.strums[k].msCounter -= (float)n;
+            if (bp.clockSource) clockAdvance(lane, (float)n, bp.clockTimeout);
+            lane.lastGateUp = lastUp;
+            lane.lastGateDown = lastDown;
+            i += n;
+            continue;
+        }
+
+        // --- Event frame ---
+        float inUp = gateUp[i];
+        float inDown = gateDown[i];
+
         // --- Detect rising edge on Trig Up and Trig Down ---
-        bool trigUp = (gateUp[i] > 1.0f && state->lastGateUp <= 1.0f);
-        bool trigDown = (gateDown[i] > 1.0f && state->lastGateDown <= 1.0f);
-        state->lastGateUp = gateUp[i];
-        state->lastGateDown = gateDown[i];
+        bool highUp = inUp > thrUp;
+        bool highDown = inDown > thrDown;
+        bool trigUp = (highUp && !levelUp);
+        bool trigDown = (highDown && !levelDown);
+
+        float lateUp = (trigUp && bp.subSample) ? edgeLateness(lane.lastGateUp, inUp, thrUp) : 0.0f;
+        float lateDown = (trigDown && bp.subSample) ? edgeLateness(lane.lastGateDown, inDown, thrDown) : 0.0f;
+
+        // --- Clock period, measured before the strum starts so it already uses the new tempo ---
+        float spacing = bp.spacingSamples;
+        if (bp.clockSource) {
+            bool clockUp = trigUp && (bp.clockSource & 1);
+            bool clockDown = trigDown && (bp.clockSource & 2);
+            if (clockUp || clockDown) clockEdge(lane, clockUp ? lateUp : lateDown, bp.clockTimeout);
+            clockAdvance(lane, 1.0f, bp.clockTimeout);
+            if (lane.clockPeriod > 0.0f) spacing = lane.clockPeriod * clockRatio; // Spacing ms until measured
+        }
 
-        // --- Envelope processing for TUp-Out and TDown-Out ---
-        int envShape = alg->v[kParamEnvShape];
-        float envExponent = alg->v[kParamEnvExponent] / 1.0f; // allow 1.00 to 8.00
+        // --- Start a strum on Trig Up (forward) and Trig Down (backward) ---
+        if (trigUp) startStrum(lane, bp.maxStrums, 0, 1, -lateUp);
+        if (trigDown) startStrum(lane, bp.maxStrums, length - 1, -1, -lateDown);
+        lane.lastGateUp = inUp;
+        lane.lastGateDown = inDown;
+        lane.levelUp = highUp;
+        lane.levelDown = highDown;
+
+        // --- Strums running, oldest first (so the newest strum's string wins the pitch output) ---
+        running = lane.strumCount > 0;
+        for (int k = 0; k < lane.strumCount; ++k) {
+            Strum& s = lane.strums[k];
+            if (s.msCounter <= bp.fireAt) {
+                // Output new note, carrying the fractional remainder so spacing never drifts
+                int position = (s.stepInc > 0) ? s.stepIndex : length - 1 - s.stepIndex;
+                float gain = shape.gain[position];
+                lane.currentPitch = pitchTable[s.stepIndex];
+                lane.lastString = (int8_t)s.stepIndex;
+                lane.lastDirection = (int8_t)s.stepInc;
+                if (bp.midiStatus) {
+                    MidiOut& midi = *alg->state->midi;
+                    bool gate = (s.stepInc > 0) ? highUp : highDown;
+                    int velocity = (int)(stringVelocity(bp, bank, midi, s, length, gate) * gain + 0.5f);
+                    midiNoteOn(midi, l, i, lane.currentPitch, (velocity < 1) ? 1 : velocity, bp);
+                }
+                if (voiceCount > 0)
+                    triggerVoice(bank, voices, s.stepIndex % voiceCount, lane.currentPitch, gain, bp.gateLenSamples);
+                s.msCounter += spacing * shape.time[position];
+                s.stepIndex += s.stepInc;
+            }
+            s.msCounter -= 1.0f;
+        }
 
-        float envUp = processEnvelope(state->tUpEnv, gateUp[i] > 1.0f, attack, decay, sustain, release, SAMPLE_RATE, envShape, envExponent);
-        float envDown = processEnvelope(state->tDownEnv, gateDown[i] > 1.0f, attack, decay, sustain, release, SAMPLE_RATE, envShape, envExponent);
+        // --- Envelopes (TUp-Out, TDown-Out, voices), in the same order as renderChannelsSpan ---
+        // The trigger envelopes run even when not routed, for the MIDI velocity.
+        for (int ch = 0; ch < co.count; ++ch) {
+            if (!co.env[ch] && ch >= CH_VOICE) continue;
+            bool gate = (ch == CH_UP) ? highUp : (ch == CH_DOWN) ? highDown : bank.pulse[ch] > 0;
+            float level = processEnvelope(bank.stage[ch], bank.value[ch], gate, env);
+            if (co.env[ch]) co.env[ch][i] = level * bank.level[ch];
+        }
 
-        tUpOut[i] = envUp * 5.0f;
-        tDownOut[i] = envDown * 5.0f;
+        // --- Gate pulse logic ---
+        if (trigUp) bank.pulse[CH_UP] = bp.gateLenSamples;
+        if (trigDown) bank.pulse[CH_DOWN] = bp.gateLenSamples;
+        for (int ch = 0; ch < co.count; ++ch) {
+            if (co.gate[ch]) co.gate[ch][i] = (bank.pulse[ch] > 0) ? 5.0f : 0.0f;
+            if (bank.pulse[ch] > 0) bank.pulse[ch]--;
+        }
 
-        // --- Gate pulse logic (unchanged) ---
-        if (trigUp) state->tUpPulse = gateLenSamples;
-        if (trigDown) state->tDownPulse = gateLenSamples;
+        // --- Pitch outputs ---
+        if (outPitch) outPitch[i] = running ? lane.currentPitch : 0.0f; // 0V when not running
+        for (int v = 0; v < voiceCount; ++v) voicePitchOut[v][i] = voices.pitch[v];
+        ++i;
+    }
+}
 
-        gateUPOut[i] = (state->tUpPulse > 0) ? 5.0f : 0.0f;
-        gateDNOut[i] = (state->tDownPulse > 0) ? 5.0f : 0.0f;
+// --- Publish the display values for this block ---
+static void publishDisplay(const _strumAlgorithm* alg) {
+    const StrumState* state = alg->state;
+    DisplayFeed& d = *state->display;
+    int scale = clampScale(state, alg->v[kParamScale] + state->mod.scaleCV);
+    bool layout = scale != d.scale || state->pitchCount != d.strings;
+    if (layout) {
+        d.scale = scale;
+        d.strings = state->pitchCount;
+        d.version[0] = d.version[0] + 1;
+    }
+    for (int l = 0; l < state->numLanes; ++l) {
+        const StrumLane& lane = state->lanes[l];
+        LaneView view;
+        view.string = lane.lastString;
+        view.direction = lane.lastDirection;
+        view.levelUp = (uint8_t)(lane.channels.value[CH_UP] * 15.0f + 0.5f);
+        view.levelDown = (uint8_t)(lane.channels.value[CH_DOWN] * 15.0f + 0.5f);
+        LaneView& shown = d.lanes[l];
+        if (layout || memcmp(&view, &shown, sizeof(view)) != 0) {
+            shown = view;
+            d.version[1 + l] = d.version[1 + l] + 1;
+        }
+    }
+}
+
+// --- Main processing loop ---
+// This function is called for each audio block to process triggers and output the note sequence.
+void step(_NT_algorithm* self, float* busFrames, int numFramesBy4) {
+    _strumAlgorithm* alg = (_strumAlgorithm*)self;
+    StrumState* state = alg->state;
+    int numFrames = numFramesBy4 * 4;
+
+    // --- Block-rate snapshot of the precomputed parameters ---
+    if (state->sampleRate != NT_globals.sampleRate) buildBlockParams(alg); // Host rate changed
+    BlockParams bp = state->params;
+    float spacingSamples = bp.spacingSamples;
+
+    // --- Control-rate chunks: CV is sampled at the start of each one ---
+    bool cvRouted = alg->v[kParamSpacingCV] || alg->v[kParamTransposeCV] ||
+                    alg->v[kParamStringsCV] || alg->v[kParamScaleCV] || alg->v[kParamRootCV];
+    int chunk = (cvRouted && bp.cvInterval > 0) ? bp.cvInterval : numFrames;
+    for (int start = 0; start < numFrames; start += chunk) {
+        int end = (start + chunk < numFrames) ? start + chunk : numFrames;
+        if (cvRouted) {
+            sampleModulation(alg, busFrames, numFrames, start);
+            if (alg->v[kParamSpacingCV]) bp.spacingSamples = spacingSamples * state->mod.spacingScale;
+        }
+
+        // --- Cached pitch table (built in parameterChanged) ---
+        if (state->pitchCount == 0) return; // No valid scale
+
+        for (int l = 0; l < state->numLanes; ++l)
+            stepLane(alg, state->lanes[l], l, bp, busFrames, numFrames, start, end);
+    }
+
+    // --- MIDI (also runs with MIDI off, so notes already sounding still get their Note Off) ---
+    MidiOut& midi = *state->midi;
+    bool pending = midi.eventCount > 0;
+    for (int l = 0; l < state->numLanes && !pending; ++l) pending = midi.noteCount[l] > 0;
+    if (pending) midiFlush(midi, state->numLanes, numFrames, bp.midiDest);
+
+    publishDisplay(alg);
+}
+
+#ifdef STRUMMER_PROFILE
+// --- Cycle counter ---
+static inline uint32_t cycleCount() {
+#if defined(__arm__)
+    return *(volatile uint32_t*)0xE0001004; // DWT_CYCCNT
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static inline void enableCycleCount() {
+#if defined(__arm__)
+    *(volatile uint32_t*)0xE000EDFC |= 1u << 24;   // DEMCR.TRCENA
+    *(volatile uint32_t*)0xE0001000 |= 1u;         // DWT_CTRL.CYCCNTENA
+#endif
+}
+
+// --- Profiled step: times the block, then records it ---
+void stepProfiled(_NT_algorithm* self, float* busFrames, int numFramesBy4) {
+    uint32_t start = cycleCount();
+    step(self, busFrames, numFramesBy4);
+    uint32_t cycles = cycleCount() - start;
 
-        if (state->tUpPulse > 0) state->tUpPulse--;
-        if (state->tDownPulse > 0) state->tDownPulse--;
+    _strumAlgorithm* alg = (_strumAlgorithm*)self;
+    const StrumState* state = alg->state;
+    ProfileStats& prof = alg->profile;
+    ++prof.blocks;
+    prof.totalCycles += cycles;
+    prof.totalFrames += numFramesBy4 * 4;
+    if (cycles < prof.minCycles) prof.minCycles = cycles;
+    if (cycles > prof.maxCycles) prof.maxCycles = cycles;
+    if (cycles <= prof.worst[PROFILE_WORST - 1].cycles) return;
+
+    // --- A new worst block: note what was active ---
+    ProfileBlock block;
+    block.cycles = cycles;
+    block.frames = (uint16_t)(numFramesBy4 * 4);
+    int strums = 0, voices = 0, notes = 0;
+    for (int l = 0; l < state->numLanes; ++l) {
+        const StrumLane& lane = state->lanes[l];
+        strums += lane.strumCount;
+        for (int v = 0; v < lane.voiceCount; ++v) voices += lane.channels.stage[CH_VOICE + v] != GateEnvelope::Off;
+        notes += state->midi->noteCount[l];
+    }
+    block.strums = (uint8_t)strums;
+    block.voices = (uint8_t)voices;
+    block.midiNotes = (uint8_t)notes;
+    block.cvRouted = alg->v[kParamSpacingCV] || alg->v[kParamTransposeCV] || alg->v[kParamStringsCV] ||
+                     alg->v[kParamScaleCV] || alg->v[kParamRootCV];
+    int k = PROFILE_WORST - 1;
+    for (; k > 0 && prof.worst[k - 1].cycles < cycles; --k) prof.worst[k] = prof.worst[k - 1];
+    prof.worst[k] = block;
+}
+
+// --- Query hook for test hosts ---
+const ProfileStats* profileStats(const _NT_algorithm* self) {
+    return &((const _strumAlgorithm*)self)->profile;
+}
 
-        // --- Start sequence on Trig Up (forward) ---
-        if (trigUp) {
-            state->stepIndex = 0;
-            state->stepInc = 1;
-            state->msCounter = 0;
+void resetProfileStats(_NT_algorithm* self) {
+    ((_strumAlgorithm*)self)->profile = ProfileStats{};
+}
+
+// --- On-screen load report ---
+// Average and peak load against the block's real-time budget, then the worst block and what
+// was active in it. The algorithm slot number tells stacked instances apart.
+bool drawProfile(_NT_algorithm* self) {
+    const ProfileStats& prof = ((_strumAlgorithm*)self)->profile;
+    if (prof.blocks == 0) return false;
+    char line[64];
+    float cyclesPerFrame = (float)PROFILE_CPU_HZ / (float)NT_globals.sampleRate;
+    float avgLoad = 100.0f * (float)prof.totalCycles / ((float)prof.totalFrames * cyclesPerFrame);
+    const ProfileBlock& w = prof.worst[0];
+    float peakLoad = 100.0f * (float)w.cycles / ((float)w.frames * cyclesPerFrame);
+
+    char* p = line;
+    p += NT_intToString(p, NT_algorithmIndex(self) + 1);
+    strcpy(p, ": avg "); p += 6;
+    p += NT_floatToString(p, avgLoad, 2);
+    strcpy(p, "% peak "); p += 7;
+    p += NT_floatToString(p, peakLoad, 2);
+    strcpy(p, "%");
+    NT_drawText(0, 20, line);
+
+    p = line;
+    strcpy(p, "cyc "); p += 4;
+    p += NT_intToString(p, (int32_t)prof.minCycles);
+    *p++ = '/';
+    p += NT_intToString(p, (int32_t)(prof.totalCycles / prof.blocks));
+    *p++ = '/';
+    p += NT_intToString(p, (int32_t)prof.maxCycles);
+    *p = 0;
+    NT_drawText(0, 32, line, 15, kNT_textLeft, kNT_textTiny);
+
+    p = line;
+    strcpy(p, "worst: strums "); p += 14;
+    p += NT_intToString(p, w.strums);
+    strcpy(p, " voices "); p += 8;
+    p += NT_intToString(p, w.voices);
+    strcpy(p, " midi "); p += 6;
+    p += NT_intToString(p, w.midiNotes);
+    if (w.cvRouted) strcpy(p, " cv");
+    NT_drawText(0, 42, line, 15, kNT_textLeft, kNT_textTiny);
+    return false;
+}
+#define STEP_CALLBACK stepProfiled
+#else
+#define STEP_CALLBACK step
+#endif
+
+// --- String view ---
+// Scale name on top, then one band per lane: a tick per string with the last string played
+// highlighted, the strum direction, and the TUp/TDown envelope levels as bars.
+static void drawLane(const DisplayFeed& d, int l, int top, int rows) {
+    const LaneView& view = d.lanes[l];
+    int bottom = top + rows - 2;
+    for (int s = 0; s < d.strings; ++s) {
+        int x = 4 + s * 10;
+        if (s == view.string) NT_drawShapeI(kNT_rectangle, x - 1, top, x + 1, bottom, 15);
+        else NT_drawShapeI(kNT_line, x, top, x, bottom, 5);
+    }
+    if (view.direction) NT_drawText(206, bottom, view.direction > 0 ? ">" : "<", 15, kNT_textLeft, kNT_textTiny);
+    int middle = (top + bottom) / 2;
+    NT_drawShapeI(kNT_box, 216, top, 254, bottom, 3);
+    if (view.levelUp) NT_drawShapeI(kNT_rectangle, 217, top + 1, 217 + view.levelUp * 36 / 15, middle, 12);
+    if (view.levelDown) NT_drawShapeI(kNT_rectangle, 217, middle + 1, 217 + view.levelDown * 36 / 15, bottom - 1, 7);
+}
+
+// Only regions whose version moved on are drawn; the rest are copied back from the pixel cache.
+bool draw(_NT_algorithm* self) {
+#ifdef STRUMMER_PROFILE
+    return drawProfile(self);   // The load report takes the screen in profiling builds
+#endif
+    const StrumState* state = ((_strumAlgorithm*)self)->state;
+    DisplayFeed& d = *state->display;
+    if (d.scale < 0) return false;  // Nothing published yet
+    int laneRows = (64 - VIEW_LANES_TOP) / state->numLanes;
+    for (int r = 0; r <= state->numLanes; ++r) {
+        int top = (r == 0) ? VIEW_TOP : VIEW_LANES_TOP + (r - 1) * laneRows;
+        int rows = (r == 0) ? VIEW_LANES_TOP - VIEW_TOP : laneRows;
+        uint8_t* screen = NT_screen + top * SCREEN_ROW_BYTES;
+        uint8_t* cache = d.pixels + (top - VIEW_TOP) * SCREEN_ROW_BYTES;
+        uint8_t version = d.version[r];
+        if (d.cached && version == d.drawn[r]) {
+            memcpy(screen, cache, rows * SCREEN_ROW_BYTES);
+            continue;
+        }
+        d.drawn[r] = version;
+        memset(screen, 0, rows * SCREEN_ROW_BYTES);
+        if (r == 0) {
+            char count[8];
+            NT_intToString(count, d.strings);
+            NT_drawText(0, top + 9, self->parameters[kParamScale].enumStrings[d.scale]);
+            NT_drawText(255, top + 9, count, 8, kNT_textRight);
+        } else {
+            drawLane(d, r - 1, top, rows);
         }
-        // --- Start sequence on Trig Down (backward) ---
-        if (trigDown) {
-            state->stepIndex = length - 1;
-            state->stepInc = -1;
-            state->msCounter = 0;
+        memcpy(cache, screen, rows * SCREEN_ROW_BYTES);
+    }
+    d.cached = true;
+    return false;
+}
+
+// --- Scala import ---
+// Tunings arrive in the preset JSON as {"scl": text, "kbm": text} and are compiled here into a
+// catalogue-style row; serialise() saves the compiled row so loading never parses again.
+// Only called from deserialise(), never from step().
+
+// Next non-comment line of a .scl/.kbm text ('!' starts a comment line)
+static bool scalaLine(const char*& p, const char*& line) {
+    while (*p) {
+        line = p;
+        while (*p && *p != '\n') ++p;
+        if (*p) ++p;
+        while (*line == ' ' || *line == '\t') ++line;
+        if (*line != '!') return true;
+    }
+    return false;
+}
+
+// Leading decimal number of a line; false if it does not start with one
+static bool scalaNumber(const char*& s, float& value, bool& isDecimal) {
+    while (*s == ' ' || *s == '\t') ++s;
+    bool negative = (*s == '-');
+    if (*s == '-' || *s == '+') ++s;
+    double v = 0.0, scale = 1.0;
+    int digits = 0;
+    isDecimal = false;
+    for (; *s >= '0' && *s <= '9'; ++s, ++digits) v = v * 10.0 + (*s - '0');
+    if (*s == '.') {
+        isDecimal = true;
+        for (++s; *s >= '0' && *s <= '9'; ++s, ++digits) v += (*s - '0') * (scale *= 0.1);
+    }
+    value = (float)(negative ? -v : v);
+    return digits > 0;
+}
+
+// One .scl pitch line in volts: cents if it has a '.', otherwise a ratio a/b or a whole number
+static bool scalaPitch(const char* s, float& volts) {
+    float a, b = 1.0f;
+    bool isDecimal;
+    if (!scalaNumber(s, a, isDecimal)) return false;
+    if (isDecimal) {
+        volts = a / 1200.0f;
+        return true;
+    }
+    if (*s == '/' && !scalaNumber(++s, b, isDecimal)) return false;
+    if (a <= 0.0f || b <= 0.0f) return false;
+    volts = log2f(a / b);
+    return true;
+}
+
+// Compiles .scl text into slot, row = 0 followed by the listed pitches (the period last).
+// Tunings that do not fit a row are rejected: cutting them would lose the period.
+static bool parseScl(UserScales& user, int slot, const char* text) {
+    const char *p = text, *line;
+    if (!scalaLine(p, line)) return false;
+    int n = 0;
+    while (line[n] && line[n] != '\n' && line[n] != '\r' && n < USER_SCALE_NAME_LEN - 1) {
+        user.name[slot][n] = line[n];
+        ++n;
+    }
+    user.name[slot][n] = 0;
+    float count;
+    bool isDecimal;
+    if (!scalaLine(p, line) || !scalaNumber(line, count, isDecimal) || isDecimal || count < 1.0f) return false;
+    if (count > (float)(SCALE_MAX_LEN - 1)) return false;
+    float* row = user.volts[slot];
+    int len = 1;
+    row[0] = 0.0f;
+    for (int i = 0; i < (int)count; ++i) {
+        if (!scalaLine(p, line) || !scalaPitch(line, row[len])) return false;
+        ++len;
+    }
+    // Catalogue rows are ascending; a .scl need not be
+    for (int i = 2; i < len; ++i)
+        for (int j = i; j > 1 && row[j - 1] > row[j]; --j) {
+            float t = row[j]; row[j] = row[j - 1]; row[j - 1] = t;
         }
+    user.length[slot] = (uint8_t)len;
+    user.root[slot] = 0.0f;
+    return true;
+}
 
-        // --- Sequence running ---
-        if (state->stepIndex >= 0 && state->stepIndex < length) {
-            if (state->msCounter <= 0) {
-                // Output new note
-                state->currentPitch = (intervals[state->stepIndex] + transpose) / 12.0f;
-                state->msCounter = spacingMs * (SAMPLE_RATE / 1000);
-                state->stepIndex += state->stepInc;
-            } else {
-                state->msCounter--;
+// Rows must look like catalogue rows: starting at 0 and ascending, so there is at least one
+// degree below the octave for the quantizer and the chords to count in.
+static bool validUserRow(const UserScales& user, int slot) {
+    const float* row = user.volts[slot];
+    int len = user.length[slot];
+    if (len < 1 || row[0] != 0.0f) return false;
+    for (int k = 1; k < len; ++k)
+        if (!(row[k] >= row[k - 1]) || !(row[k] < 1.0e3f)) return false;   // Also rejects NaN/inf
+    return true;
+}
+
+// Pitch of a scale degree, repeating the row by its last entry (the period)
+static float userDegreePitch(const UserScales& user, int slot, int degree) {
+    int steps = user.length[slot] - 1;
+    if (steps < 1) return 0.0f;
+    int octave = degreeOctave(degree, steps);
+    return user.volts[slot][degree - octave * steps] + (float)octave * user.volts[slot][steps];
+}
+
+// Applies .kbm text to a compiled slot. The mapping picks and orders the degrees of one
+// repeat (unmapped 'x' keys are left out) and the reference note/frequency set the pitch of
+// the first string, relative to middle C at 0V. The keyboard range is not used.
+static bool parseKbm(UserScales& user, int slot, const char* text) {
+    const char *p = text, *line;
+    float header[7];   // Map size, first note, last note, middle note, reference note, Hz, octave degree
+    bool isDecimal;
+    for (int i = 0; i < 7; ++i)
+        if (!scalaLine(p, line) || !scalaNumber(line, header[i], isDecimal)) return false;
+    int mapSize = (int)header[0], middle = (int)header[3], reference = (int)header[4];
+    int octaveDegree = (int)header[6];
+    if (mapSize < 0 || header[5] <= 0.0f) return false;
+    int steps = user.length[slot] - 1;
+
+    // --- Key mapping: the degrees of one repeat, plus the repeat itself ---
+    int mapping[SCALE_MAX_LEN];
+    for (int k = 0; k < SCALE_MAX_LEN; ++k) mapping[k] = -1;
+    int mapped = 0;
+    for (int k = 0; k < mapSize; ++k) {
+        if (!scalaLine(p, line)) break;   // Missing entries are unmapped
+        float degree;
+        if (k < SCALE_MAX_LEN && scalaNumber(line, degree, isDecimal)) mapping[k] = (int)degree;
+    }
+    if (mapSize > SCALE_MAX_LEN) mapSize = SCALE_MAX_LEN;
+    if (octaveDegree <= 0) octaveDegree = steps;
+
+    // --- Pitch of the reference key relative to the middle key, through the mapping ---
+    int key = reference - middle;
+    int degree = key;
+    if (mapSize > 0) {
+        int octave = degreeOctave(key, mapSize);
+        int m = mapping[key - octave * mapSize];
+        if (m < 0) return false;          // Reference note unmapped
+        degree = m + octave * octaveDegree;
+    }
+    float root = log2f(header[5] / 261.6256f) - userDegreePitch(user, slot, degree);
+
+    if (mapSize > 0) {
+        float row[SCALE_MAX_LEN];
+        for (int k = 0; k < mapSize && mapped < SCALE_MAX_LEN - 1; ++k)
+            if (mapping[k] >= 0) row[mapped++] = userDegreePitch(user, slot, mapping[k]);
+        if (mapped == 0) return false;
+        float repeat = userDegreePitch(user, slot, octaveDegree);
+        for (int i = 1; i < mapped; ++i)
+            for (int j = i; j > 0 && row[j - 1] > row[j]; --j) {
+                float t = row[j]; row[j] = row[j - 1]; row[j - 1] = t;
             }
-            outPitch[i] = state->currentPitch; // Always output current pitch while running
-        } else {
-            outPitch[i] = 0.0f; // Not running: output 0V
-            // Do NOT reset state variables here, so retriggering works
+        // Rows start at 0: fold the first mapped degree into the root
+        float first = row[0];
+        for (int i = 0; i < mapped; ++i) user.volts[slot][i] = row[i] - first;
+        user.volts[slot][mapped] = repeat;
+        user.length[slot] = (uint8_t)(mapped + 1);
+        root += first;
+    }
+    user.root[slot] = root;
+    return true;
+}
+
+// Points the Scale enum at the current list and tells the host its range changed
+static void publishUserScales(_strumAlgorithm* alg) {
+    StrumState* state = alg->state;
+    UserScales& user = *state->userScales;
+    for (int i = 0; i < user.count; ++i) user.scaleNames[NUM_SCALES + i] = user.name[i];
+    user.scaleNames[NUM_SCALES + user.count] = NULL;
+    user.paramTable[kParamScale].max = NUM_SCALES + user.count - 1;
+    state->voicings->scale = -1;          // Slots may hold a different tuning now
+    NT_updateParameterDefinition(NT_algorithmIndex(alg), kParamScale);
+    buildPitchTable(alg);
+}
+
+void serialise(_NT_algorithm* self, _NT_jsonStream& stream) {
+    const UserScales& user = *((_strumAlgorithm*)self)->state->userScales;
+    stream.addMemberName("userScales");
+    stream.openArray();
+    for (int i = 0; i < user.count; ++i) {
+        stream.openObject();
+        stream.addMemberName("name");
+        stream.addString(user.name[i]);
+        stream.addMemberName("root");
+        stream.addNumber(user.root[i]);
+        stream.addMemberName("volts");
+        stream.openArray();
+        for (int k = 0; k < user.length[i]; ++k) stream.addNumber(user.volts[i][k]);
+        stream.closeArray();
+        stream.closeObject();
+    }
+    stream.closeArray();
+}
+
+bool deserialise(_NT_algorithm* self, _NT_jsonParse& parse) {
+    _strumAlgorithm* alg = (_strumAlgorithm*)self;
+    UserScales& user = *alg->state->userScales;
+    int members;
+    if (!parse.numberOfObjectMembers(members)) return false;
+    for (int m = 0; m < members; ++m) {
+        if (!parse.matchName("userScales")) {
+            if (!parse.skipMember()) return false;
+            continue;
+        }
+        int scales;
+        if (!parse.numberOfArrayElements(scales)) return false;
+        user.count = 0;
+        for (int s = 0; s < scales; ++s) {
+            int slot = (user.count < MAX_USER_SCALES) ? user.count : MAX_USER_SCALES; // Extras are parsed and dropped
+            if (slot < MAX_USER_SCALES) {
+                user.name[slot][0] = 0;
+                user.length[slot] = 0;
+                user.root[slot] = 0.0f;
+            }
+            int fields;
+            if (!parse.numberOfObjectMembers(fields)) return false;
+            bool ok = true;
+            char kbm[512] = {};                   // Applied once the .scl is in, whatever the member order
+            for (int f = 0; f < fields; ++f) {
+                const char* text;
+                int count;
+                if (parse.matchName("scl")) {
+                    if (!parse.string(text)) return false;
+                    ok = ok && slot < MAX_USER_SCALES && parseScl(user, slot, text);
+                } else if (parse.matchName("kbm")) {
+                    if (!parse.string(text)) return false;
+                    strncpy(kbm, text, sizeof(kbm) - 1);
+                } else if (parse.matchName("name")) {
+                    if (!parse.string(text)) return false;
+                    if (slot < MAX_USER_SCALES) {
+                        strncpy(user.name[slot], text, USER_SCALE_NAME_LEN - 1);
+                        user.name[slot][USER_SCALE_NAME_LEN - 1] = 0;
+                    }
+                } else if (parse.matchName("root")) {
+                    float root;
+                    if (!parse.number(root)) return false;
+                    if (slot < MAX_USER_SCALES) user.root[slot] = root;
+                } else if (parse.matchName("volts")) {
+                    if (!parse.numberOfArrayElements(count)) return false;
+                    for (int k = 0; k < count; ++k) {
+                        float v;
+                        if (!parse.number(v)) return false;
+                        if (slot < MAX_USER_SCALES && k < SCALE_MAX_LEN) user.volts[slot][k] = v;
+                    }
+                    if (slot < MAX_USER_SCALES) user.length[slot] = (uint8_t)((count < SCALE_MAX_LEN) ? count : SCALE_MAX_LEN);
+                    ok = ok && count > 0;
+                } else if (!parse.skipMember()) {
+                    return false;
+                }
+            }
+            if (slot == MAX_USER_SCALES || !ok || !validUserRow(user, slot)) continue;
+            if (kbm[0] && (!parseKbm(user, slot, kbm) || !validUserRow(user, slot))) continue;
+            if (!user.name[slot][0]) {
+                strcpy(user.name[slot], "User ");
+                NT_intToString(user.name[slot] + 5, slot + 1);
+            }
+            ++user.count;
         }
     }
+    publishUserScales(alg);
+    return true;
 }
 
 // --- Forward declarations for factory ---
 void calculateRequirements(_NT_algorithmRequirements& req, const int32_t*);
-_NT_algorithm* construct(const _NT_algorithmMemoryPtrs& ptrs, const _NT_algorithmRequirements&, const int32_t*);
+_NT_algorithm* construct(const _NT_algorithmMemoryPtrs& ptrs, const _NT_algorithmRequirements&, const int32_t* specs);
 
 // --- Factory definition ---
 static const _NT_factory factory = {
     .guid = NT_MULTICHAR('F','M','S','M'),
     .name = "Strummer",
     .description = "X-notes strummer",
-    .numSpecifications = 0,
+    .numSpecifications = sizeof(specifications) / sizeof(specifications[0]),
+    .specifications = specifications,
     .calculateRequirements = calculateRequirements,
     .construct = construct,
-    .parameterChanged = NULL,
-    .step = step,
-    .draw = NULL,
+    .parameterChanged = parameterChanged,
+    .step = STEP_CALLBACK,
+    .draw = draw,
     .midiMessage = NULL,
+    .serialise = serialise,
+    .deserialise = deserialise,
 };
 
 // --- Plugin entry point ---
@@ -626,20 +2405,55 @@ uintptr_t pluginEntry(_NT_selector selector, uint32_t data) {
 }
 
 // --- Algorithm requirements calculation ---
-void calculateRequirements(_NT_algorithmRequirements& req, const int32_t*) {
-    req.numParameters = kNumParams;
+void calculateRequirements(_NT_algorithmRequirements& req, const int32_t* specs) {
+    int lanes = specs[0];
+    req.numParameters = kNumParams + (lanes - 1) * kNumLaneParams;
     req.sram = sizeof(_strumAlgorithm);
-    req.dram = sizeof(StrumState);
-    req.dtc = 0;
+    req.dram = DISPLAY_OFFSET + sizeof(DisplayFeed);
+    req.dtc = LANES_OFFSET + lanes * sizeof(StrumLane); // Hot state, see "Memory placement"
     req.itc = 0;
 }
 
 // --- Algorithm construction ---
-_NT_algorithm* construct(const _NT_algorithmMemoryPtrs& ptrs, const _NT_algorithmRequirements&, const int32_t*) {
+_NT_algorithm* construct(const _NT_algorithmMemoryPtrs& ptrs, const _NT_algorithmRequirements&, const int32_t* specs) {
     _strumAlgorithm* alg = reinterpret_cast<_strumAlgorithm*>(ptrs.sram);
-    alg->state = reinterpret_cast<StrumState*>(ptrs.dram);
+    alg->state = reinterpret_cast<StrumState*>(ptrs.dtc);
     *alg->state = StrumState{}; // Zero-initialize state
-    alg->parameters = parameters;
+    alg->state->numLanes = specs[0];
+    alg->state->lanes = reinterpret_cast<StrumLane*>(ptrs.dtc + LANES_OFFSET);
+    for (int l = 0; l < alg->state->numLanes; ++l) {
+        alg->state->lanes[l] = StrumLane{};
+        for (int ch = 0; ch < NUM_CHANNELS_PADDED; ++ch) alg->state->lanes[l].channels.level[ch] = 5.0f;
+    }
+    alg->state->voicings = reinterpret_cast<VoicingCache*>(ptrs.dram);
+    *alg->state->voicings = VoicingCache{};
+    alg->state->midi = reinterpret_cast<MidiOut*>(ptrs.dram + MIDI_OFFSET);
+    *alg->state->midi = MidiOut{};
+    for (int k = 0; k < SCALE_MAX_LEN; ++k)
+        alg->state->midi->velCurve[k] = (uint8_t)(127.0f * powf(0.94f, (float)k) + 0.5f);
+    // --- Own copy of the parameter table, so imported tunings can extend the Scale enum ---
+    UserScales* user = reinterpret_cast<UserScales*>(ptrs.dram + USER_OFFSET);
+    *user = UserScales{};
+    memcpy(user->paramTable, parameters, sizeof(parameters));
+    // The Scale range covers every slot from the start, so a preset's Scale value survives
+    // however the host orders restoring parameters and deserialise(); empty slots play the
+    // last loaded scale.
+    for (int i = 0; i < NUM_SCALES; ++i) user->scaleNames[i] = all_scale_names[i];
+    for (int i = 0; i < MAX_USER_SCALES; ++i) {
+        strcpy(user->name[i], "User ");
+        NT_intToString(user->name[i] + 5, i + 1);
+        user->scaleNames[NUM_SCALES + i] = user->name[i];
+    }
+    user->paramTable[kParamScale].max = NUM_SCALES + MAX_USER_SCALES - 1;
+    user->paramTable[kParamScale].enumStrings = user->scaleNames;
+    alg->state->userScales = user;
+    alg->state->display = reinterpret_cast<DisplayFeed*>(ptrs.dram + DISPLAY_OFFSET);
+    *alg->state->display = DisplayFeed{};
+    alg->parameters = user->paramTable;
+#ifdef STRUMMER_PROFILE
+    alg->profile = ProfileStats{};
+    enableCycleCount();
+#endif
     alg->parameterPages = NULL;
     return alg;
 }
\ No newline at end of file
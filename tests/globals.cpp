@@ -0,0 +1,8 @@
+// NT_globals is const to the plugin; the test host defines it here, away from api.h,
+// so it can set the sample rate for each scenario.
+#include <stdint.h>
+
+struct _NT_globals { uint32_t sampleRate; uint32_t maxFramesPerStep; float* workBuffer; uint32_t workBufferSizeBytes; };
+
+_NT_globals NT_globals = { 48000, 128, 0, 0 };
+_NT_globals& testGlobals = NT_globals;
@@ -0,0 +1,632 @@
+// Off-hardware test host for Strummer.
+//
+// Loads the plugin through pluginEntry like the distingNT does, runs a fixed table of
+// scenarios with scripted trigger and CV inputs, and hashes each bus, the MIDI messages and
+// the saved preset of every scenario separately. The hashes, and the memory each lane count
+// asks for, are compared against golden.txt, so any change to the output or the footprint
+// shows up here and a mismatch names the bus that moved.
+//
+// To find the first frame that differs, one build dumps its raw output and another compares
+// against it as it runs; the Makefile does this for the STRUMMER_NO_SIMD, STRUMMER_NO_SPANS
+// and STRUMMER_PROFILE builds, which must match the default build exactly.
+//
+//   strummer_test golden.txt            check, exit status 1 on any mismatch
+//   strummer_test --update golden.txt   rewrite the golden file from this build
+//   strummer_test --dump FILE           write the raw output ("-" for stdout)
+//   strummer_test --compare FILE        print the first difference from a dump, per scenario
+//   strummer_test --bench               time step() over a parameter sweep, CSV on stdout
+
+#include "host_api.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef STRUMMER_PROFILE
+// Layout of Strummer.cpp's ProfileStats, read through its profileStats() hook
+struct ProfileBlock {
+    uint32_t cycles;
+    uint16_t frames;
+    uint8_t strums, voices, midiNotes, cvRouted;
+};
+
+struct ProfileStats {
+    uint32_t blocks, minCycles, maxCycles;
+    uint64_t totalCycles, totalFrames;
+    ProfileBlock worst[4];
+};
+
+const ProfileStats* profileStats(const _NT_algorithm* self);
+void resetProfileStats(_NT_algorithm* self);
+#endif
+
+#define STREAM_MIDI NUM_BUSSES          // Hashed streams: the busses, then MIDI and the preset
+#define STREAM_PRESET (NUM_BUSSES + 1)
+#define NUM_STREAMS (NUM_BUSSES + 2)
+
+// --- Output hashes (64-bit FNV-1a, one per stream) ---
+static uint64_t streamHash[NUM_STREAMS];
+
+static void hashBytes(int stream, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h = streamHash[stream];
+    for (size_t i = 0; i < size; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    streamHash[stream] = h;
+}
+
+// --- Scenarios ---
+// Inputs on every run: busses 1/2 and 3/4 carry the trigger pairs of lanes 1 and 2,
+// 5 a slow sine (-2..2 V), 6..8 stepped CVs. Parameters route them as each scenario needs.
+// kTrigHeld sits at 3 V with short drops to 0 V, so lowering Threshold under 3 V triggers
+// without a crossing.
+enum TriggerStyle { kTrigSquare, kTrigRamp, kTrigNoisy, kTrigHeld };
+
+#define MAX_SETTINGS 12
+#define LAST 32767                      // The parameter's max; LAST - n is n below it (e.g. user Scales)
+
+struct Setting {
+    const char* name;
+    int value;
+};
+
+struct Scenario {
+    const char* name;
+    int sampleRate;
+    int lanes;
+    int framesBy4;
+    int blocks;
+    TriggerStyle triggers;
+    Setting settings[MAX_SETTINGS];
+    Setting later[2];                   // Applied halfway through the run
+    const char* preset;                 // JSON handed to deserialise() before the run
+    int reload;                         // 1/2: save, then run a fresh instance restored values/preset first
+};
+
+static const char* tuningPreset =
+    "{\"userScales\":[{\"scl\":\"! meantone.scl\\n1/4-comma meantone\\n 7\\n!\\n"
+    " 193.157\\n 386.314\\n 503.422\\n 696.579\\n 889.735\\n 1082.892\\n 2/1\\n\",\"name\":\"Meantone\"},"
+    "{\"scl\":\"22-EDO, too long for a row: dropped\\n22\\n55.\\n109.\\n164.\\n218.\\n273.\\n327.\\n382.\\n436.\\n491.\\n545.\\n600.\\n655.\\n709.\\n764.\\n818.\\n873.\\n927.\\n982.\\n1036.\\n1091.\\n1145.\\n2/1\\n\"},"
+    "{\"scl\":\"Slendro\\n5\\n240.\\n480.\\n720.\\n960.\\n2/1\\n\","
+    "\"kbm\":\"5\\n0\\n127\\n60\\n69\\n440.0\\n5\\n0\\n1\\n2\\n3\\n4\\n\"}]}";
+
+// .kbm listing 7 of its 12 mapping entries: the missing keys are unmapped
+static const char* sparseKbmPreset =
+    "{\"userScales\":[{\"scl\":\"12-EDO\\n12\\n100.\\n200.\\n300.\\n400.\\n500.\\n600.\\n700.\\n"
+    "800.\\n900.\\n1000.\\n1100.\\n2/1\\n\",\"kbm\":\"12\\n0\\n127\\n60\\n69\\n440.0\\n12\\n"
+    "0\\n2\\n4\\n5\\n7\\n9\\n11\\n\"}]}";
+
+// Compiled rows as saved in a preset; only "Good" is catalogue-shaped
+static const char* badRowsPreset =
+    "{\"userScales\":[{\"name\":\"Offset\",\"root\":0,\"volts\":[0.1,0.3,1]},"
+    "{\"name\":\"Falling\",\"root\":0,\"volts\":[0,0.5,0.3,1]},"
+    "{\"name\":\"Huge\",\"root\":0,\"volts\":[0,0.5,5000]},"
+    "{\"name\":\"Empty\",\"root\":0,\"volts\":[]},"
+    "{\"name\":\"Good\",\"root\":0.25,\"volts\":[0,0.25,0.5,0.75,1]}]}";
+
+static const Scenario scenarios[] = {
+    { .name = "defaults", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare },
+    { .name = "envelopes", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Attack ms", 20 }, { "Decay ms", 150 }, { "Sustain %", 60 }, { "Release ms", 300 },
+                    { "Env Shape", 1 }, { "Env Exponent", 4 }, { "Gate Len ms", 40 } } },
+    { .name = "envelopes-long", .sampleRate = 48000, .lanes = 1, .framesBy4 = 16, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Attack ms", 4000 }, { "Decay ms", 3000 }, { "Sustain %", 30 }, { "Release ms", 9000 },
+                    { "Env Shape", 2 }, { "Spacing ms", 7 }, { "Strings", 12 } } },
+    { .name = "scale-transpose", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Scale", 23 }, { "Strings", 9 }, { "Transpose", -7 }, { "Mask Rotate", 3 }, { "Spacing ms", 30 } },
+      .later = { { "Strings", 4 }, { "Scale", 5 } } },
+    { .name = "voices", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Voices", 4 }, { "Voice Out", 19 }, { "Attack ms", 5 }, { "Release ms", 400 }, { "Spacing ms", 25 } } },
+    { .name = "voices-trigger-env", .sampleRate = 48000, .lanes = 1, .framesBy4 = 4, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Voices", 5 }, { "Voice Out", 17 }, { "Voice Env", 1 }, { "Decay ms", 80 }, { "Sustain %", 40 } } },
+    { .name = "cv-block-rate", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Spacing CV", 5 }, { "Transpose CV", 6 }, { "Strings CV", 7 }, { "Scale CV", 8 }, { "CV Rate", 0 } } },
+    { .name = "cv-sample-rate", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Spacing CV", 5 }, { "Transpose CV", 6 }, { "Strings CV", 7 }, { "Scale CV", 8 }, { "CV Rate", 1 } } },
+    { .name = "cv-decimated", .sampleRate = 48000, .lanes = 1, .framesBy4 = 32, .blocks = 600, .triggers = kTrigSquare,
+      .settings = { { "Spacing CV", 5 }, { "Transpose CV", 6 }, { "Strings CV", 7 }, { "Scale CV", 8 }, { "CV Rate", 2 } } },
+    { .name = "root-cv", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Root CV", 5 }, { "Scale", 2 }, { "Strings", 8 } } },
+    { .name = "chords-scale-cv", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Chord", 2 }, { "Scale CV", 8 }, { "Transpose CV", 6 }, { "Strings", 10 }, { "Voices", 3 } },
+      .later = { { "Chord", 5 } } },
+    { .name = "max-strums", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Max Strums", 4 }, { "Spacing ms", 300 }, { "Strings", 14 }, { "Voices", 6 } } },
+    { .name = "sub-sample", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigRamp,
+      .settings = { { "Timing", 1 }, { "Threshold", 25 }, { "Hysteresis", 5 }, { "Spacing ms", 3 } },
+      .later = { { "Threshold", 40 } } },
+    { .name = "hysteresis", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigNoisy,
+      .settings = { { "Threshold", 20 }, { "Hysteresis", 12 } } },
+    { .name = "spacing-clock-1", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Spacing Mode", 1 }, { "Strum Fill %", 70 } } },
+    { .name = "spacing-clock-2", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Spacing Mode", 2 }, { "Strum Fill %", 35 }, { "Strings", 11 } } },
+    { .name = "spacing-clock-3", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Spacing Mode", 3 }, { "Strum Fill %", 90 } } },
+    { .name = "midi-envelope", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "MIDI Channel", 3 }, { "MIDI Dest", 4 }, { "Velocity", 0 }, { "Attack ms", 30 }, { "Decay ms", 100 } } },
+    { .name = "midi-curve", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "MIDI Channel", 16 }, { "MIDI Dest", 2 }, { "Velocity", 1 }, { "Voices", 2 } } },
+    { .name = "midi-fixed", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "MIDI Channel", 1 }, { "Velocity", 2 }, { "Max Strums", 3 } } },
+    { .name = "shape-accelerando", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Strum Shape", 1 }, { "Shape Depth", 80 }, { "Voices", 4 }, { "MIDI Channel", 2 } } },
+    { .name = "shape-ritardando", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Strum Shape", 2 }, { "Shape Depth", 100 }, { "Voices", 4 }, { "MIDI Channel", 2 } },
+      .later = { { "Strings", 9 } } },
+    { .name = "shape-human", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "Strum Shape", 3 }, { "Shape Seed", 7 }, { "Spacing Mode", 1 }, { "MIDI Channel", 2 } } },
+    { .name = "two-lanes", .sampleRate = 48000, .lanes = 2, .framesBy4 = 8, .blocks = 1800, .triggers = kTrigSquare,
+      .settings = { { "2 TUp Out", 23 }, { "2 GateUP_Out", 24 }, { "2 Voice Out", 25 }, { "Voices", 2 },
+                    { "MIDI Channel", 5 }, { "Strum Shape", 3 } } },
+    { .name = "rate-44k-small-blocks", .sampleRate = 44100, .lanes = 1, .framesBy4 = 1, .blocks = 8000, .triggers = kTrigSquare,
+      .settings = { { "Voices", 2 }, { "Timing", 1 }, { "Spacing CV", 5 }, { "CV Rate", 1 } } },
+    { .name = "rate-96k-large-blocks", .sampleRate = 96000, .lanes = 1, .framesBy4 = 32, .blocks = 800, .triggers = kTrigRamp,
+      .settings = { { "Voices", 2 }, { "Timing", 1 }, { "Spacing CV", 5 }, { "CV Rate", 2 } } },
+    { .name = "scala", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Scale", LAST }, { "Strings", 8 }, { "Chord", 1 } },
+      .later = { { "Scale", LAST - 1 } },
+      .preset = tuningPreset },
+    // Regressions: Threshold lowered under a held input (no crossing to interpolate) ...
+    { .name = "threshold-under-held-input", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigHeld,
+      .settings = { { "Timing", 1 }, { "Threshold", 40 }, { "Spacing Mode", 1 }, { "Voices", 2 }, { "MIDI Channel", 1 } },
+      .later = { { "Threshold", 20 } } },
+    // ... a .kbm with missing mapping entries, and compiled rows that must be rejected
+    { .name = "scala-sparse-kbm", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 600, .triggers = kTrigSquare,
+      .settings = { { "Scale", LAST }, { "Strings", 12 }, { "Root CV", 5 } },
+      .preset = sparseKbmPreset },
+    { .name = "scala-bad-rows", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 600, .triggers = kTrigSquare,
+      .settings = { { "Scale", LAST }, { "Strings", 9 } },
+      .preset = badRowsPreset },
+    // Same run after a save and reload, in both restore orders: must hash like "scala"
+    { .name = "scala-reload-values-first", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Scale", LAST }, { "Strings", 8 }, { "Chord", 1 } },
+      .later = { { "Scale", LAST - 1 } },
+      .preset = tuningPreset, .reload = 1 },
+    { .name = "scala-reload-preset-first", .sampleRate = 48000, .lanes = 1, .framesBy4 = 8, .blocks = 1200, .triggers = kTrigSquare,
+      .settings = { { "Scale", LAST }, { "Strings", 8 }, { "Chord", 1 } },
+      .later = { { "Scale", LAST - 1 } },
+      .preset = tuningPreset, .reload = 2 },
+};
+
+// --- Input script ---
+struct Inputs {
+    uint32_t rng;
+    int remaining[2];                   // Frames left in the current half-cycle, per trigger pair
+    bool high[2];
+    float level[2];
+    long frame;
+};
+
+static uint32_t nextRandom(Inputs& in) {
+    in.rng = in.rng * 1664525u + 1013904223u;
+    return in.rng >> 8;
+}
+
+static float triggerLevel(Inputs& in, int pair, TriggerStyle style) {
+    if (--in.remaining[pair] <= 0) {
+        in.high[pair] = !in.high[pair];
+        in.remaining[pair] = 40 + (int)(nextRandom(in) % (in.high[pair] ? 1500 : 3000));
+    }
+    float target = in.high[pair] ? 5.0f : 0.0f;
+    if (style == kTrigRamp) {           // Edges take ~9 frames, so crossings land between samples
+        float step = 0.55f + 0.003f * pair;
+        in.level[pair] += (target > in.level[pair]) ? fminf(step, target - in.level[pair]) : -fminf(step, in.level[pair] - target);
+        return in.level[pair];
+    }
+    if (style == kTrigNoisy) return target + (float)(nextRandom(in) % 2000) * 0.001f - 1.0f;
+    if (style == kTrigHeld) return (in.frame % (7000 + 1000 * pair) < 300) ? 0.0f : 3.0f;
+    return target;
+}
+
+static void fillInputs(Inputs& in, float* busFrames, int numFrames, TriggerStyle style) {
+    memset(busFrames, 0, sizeof(float) * NUM_BUSSES * numFrames);
+    for (int i = 0; i < numFrames; ++i, ++in.frame) {
+        float up = triggerLevel(in, 0, style);
+        float down = triggerLevel(in, 1, style);
+        busFrames[0 * numFrames + i] = up;
+        busFrames[1 * numFrames + i] = down;
+        busFrames[2 * numFrames + i] = (in.frame % 11000 < 5500) ? up : 0.0f;
+        busFrames[3 * numFrames + i] = (in.frame % 11000 < 5500) ? 0.0f : down;
+        busFrames[4 * numFrames + i] = 2.0f * sinf((float)in.frame * 0.00021f);
+        busFrames[5 * numFrames + i] = (float)((in.frame / 3001) % 5) * 0.25f;
+        busFrames[6 * numFrames + i] = (float)((in.frame / 7007) % 4 - 1) / 12.0f;
+        busFrames[7 * numFrames + i] = (float)((in.frame / 20011) % 3) / 12.0f;
+    }
+}
+
+// --- Runner ---
+// Parameter values the way the host restores them: clamped to the range known at the time
+static void restoreValues(const _NT_factory* factory, Instance& inst, const std::vector<int16_t>& saved) {
+    for (size_t p = 0; p < saved.size(); ++p) {
+        const _NT_parameter& param = inst.alg->parameters[p];
+        int16_t v = saved[p];
+        inst.values[p] = (v < param.min) ? param.min : (v > param.max) ? param.max : v;
+        factory->parameterChanged(inst.alg, (int)p);
+    }
+}
+
+// Saves inst and replaces it with a fresh instance loaded from the save
+static bool reload(const _NT_factory* factory, const Scenario& sc, Instance& inst) {
+    std::string preset = serialise(factory, inst.alg);
+    std::vector<int16_t> saved = inst.values;
+    construct(factory, sc.lanes, inst);
+    if (sc.reload == 2 && !deserialise(factory, inst.alg, preset.c_str())) return false;
+    restoreValues(factory, inst, saved);
+    if (sc.reload == 1 && !deserialise(factory, inst.alg, preset.c_str())) return false;
+    for (size_t p = 0; p < saved.size(); ++p) {
+        if (inst.values[p] == saved[p]) continue;
+        fprintf(stderr, "%s: \"%s\" restored as %d, saved %d\n", sc.name, inst.alg->parameters[p].name,
+                inst.values[p], saved[p]);
+        return false;
+    }
+    return true;
+}
+
+static bool applySetting(const _NT_factory* factory, Instance& inst, const Setting& setting) {
+    int p = findParameter(inst.alg, (int)inst.values.size(), setting.name);
+    if (p < 0) return false;
+    int max = inst.alg->parameters[p].max;
+    setParameter(factory, inst, p, (setting.value > LAST - 100) ? max - (LAST - setting.value) : setting.value);
+    return true;
+}
+
+// --- Raw output streams ---
+// Per scenario: its name, then per block the MIDI messages (4 bytes each) and every bus,
+// then the saved preset. --compare reads a dump record by record while running.
+static FILE* dumpFile;
+static FILE* compareFile;
+
+static void writeRecord(const void* data, uint32_t size) {
+    fwrite(&size, sizeof(size), 1, dumpFile);
+    fwrite(data, 1, size, dumpFile);
+}
+
+static bool readRecord(std::vector<uint8_t>& data) {
+    uint32_t size;
+    if (fread(&size, sizeof(size), 1, compareFile) != 1) return false;
+    data.resize(size);
+    return fread(data.data(), 1, size, compareFile) == size;
+}
+
+struct Comparison {
+    const char* scenario;
+    bool differs;
+    bool lost;                          // The dump ended or is out of step
+    std::vector<uint8_t> record;
+};
+
+static void compareFailed(Comparison& cmp, const char* format, ...) __attribute__((format(printf, 2, 3)));
+static void compareFailed(Comparison& cmp, const char* format, ...) {
+    if (cmp.differs) return;            // Only the first difference of a scenario
+    cmp.differs = true;
+    va_list args;
+    va_start(args, format);
+    printf("DIFF %s: ", cmp.scenario);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+// Compares one record of this run against the next one in the dump
+static bool compareRecord(Comparison& cmp, const void* data, uint32_t size) {
+    if (cmp.lost) return false;
+    if (!readRecord(cmp.record)) {
+        cmp.lost = true;
+        compareFailed(cmp, "reference dump ended");
+        return false;
+    }
+    return cmp.record.size() == size && !memcmp(cmp.record.data(), data, size);
+}
+
+static void compareBlock(Comparison& cmp, int block, const float* busFrames, int numFrames) {
+    if (!compareRecord(cmp, sentMidi.data(), (uint32_t)sentMidi.size()) && !cmp.lost) {
+        size_t k = 0;
+        while (k + 4 <= sentMidi.size() && k + 4 <= cmp.record.size() && !memcmp(&sentMidi[k], &cmp.record[k], 4)) k += 4;
+        char got[16] = "none", expected[16] = "none";
+        if (k < sentMidi.size()) snprintf(got, sizeof(got), "%02x %02x %02x", sentMidi[k + 1], sentMidi[k + 2], sentMidi[k + 3]);
+        if (k < cmp.record.size()) snprintf(expected, sizeof(expected), "%02x %02x %02x", cmp.record[k + 1], cmp.record[k + 2], cmp.record[k + 3]);
+        compareFailed(cmp, "block %d: MIDI message %d is %s, expected %s", block, (int)(k / 4), got, expected);
+    }
+    uint32_t size = (uint32_t)(NUM_BUSSES * numFrames * sizeof(float));
+    if (compareRecord(cmp, busFrames, size) || cmp.lost) return;
+    if (cmp.record.size() != size) {
+        compareFailed(cmp, "block %d: block sizes differ", block);
+        return;
+    }
+    const float* expected = (const float*)cmp.record.data();
+    for (int i = 0; i < numFrames; ++i)
+        for (int b = 0; b < NUM_BUSSES; ++b) {
+            int k = b * numFrames + i;
+            if (!memcmp(&expected[k], &busFrames[k], sizeof(float))) continue;
+            compareFailed(cmp, "bus %d, frame %d (block %d): %.9g, expected %.9g", b + 1, block * numFrames + i,
+                          block, busFrames[k], expected[k]);
+            return;
+        }
+}
+
+// --- Checks ---
+// A named row of values, one line of golden.txt
+struct Check {
+    std::string name;
+    std::vector<std::string> labels;
+    std::vector<std::string> values;
+
+    void add(const std::string& label, uint64_t value, bool hex) {
+        char text[24];
+        snprintf(text, sizeof(text), hex ? "%016llx" : "%llu", (unsigned long long)value);
+        labels.push_back(label);
+        values.push_back(text);
+    }
+
+    std::string line() const {
+        std::string text = name;
+        for (size_t k = 0; k < values.size(); ++k) text += " " + values[k];
+        return text;
+    }
+};
+
+static bool runScenario(const _NT_factory* factory, const Scenario& sc, Check& check) {
+    testGlobals.sampleRate = sc.sampleRate;
+    testGlobals.maxFramesPerStep = sc.framesBy4 * 4;
+
+    Instance inst;
+    construct(factory, sc.lanes, inst);
+    if (sc.preset && !deserialise(factory, inst.alg, sc.preset)) {
+        fprintf(stderr, "%s: deserialise failed\n", sc.name);
+        return false;
+    }
+    for (int s = 0; s < MAX_SETTINGS && sc.settings[s].name; ++s)
+        if (!applySetting(factory, inst, sc.settings[s])) return false;
+    if (sc.reload && !reload(factory, sc, inst)) return false;
+    _NT_algorithm* alg = inst.alg;
+
+    for (int k = 0; k < NUM_STREAMS; ++k) streamHash[k] = 1469598103934665603ull;
+    Comparison cmp = { sc.name, false, false, std::vector<uint8_t>() };
+    if (dumpFile) writeRecord(sc.name, (uint32_t)strlen(sc.name));
+    if (compareFile && !compareRecord(cmp, sc.name, (uint32_t)strlen(sc.name))) {
+        compareFailed(cmp, "dump is out of step (next scenario there is \"%.*s\")", (int)cmp.record.size(),
+                      (const char*)cmp.record.data());
+        cmp.lost = true;
+    }
+
+    int numFrames = sc.framesBy4 * 4;
+    std::vector<float> bus(NUM_BUSSES * numFrames);
+    Inputs in = { 12345u + (uint32_t)sc.blocks, { 1, 1 }, { false, false }, { 0.0f, 0.0f }, 0 };
+    for (int b = 0; b < sc.blocks; ++b) {
+        if (b == sc.blocks / 2)
+            for (int s = 0; s < 2 && sc.later[s].name; ++s)
+                if (!applySetting(factory, inst, sc.later[s])) return false;
+        fillInputs(in, bus.data(), numFrames, sc.triggers);
+        sentMidi.clear();
+        factory->step(alg, bus.data(), sc.framesBy4);
+        hashBytes(STREAM_MIDI, sentMidi.data(), sentMidi.size());
+        for (int k = 0; k < NUM_BUSSES; ++k) hashBytes(k, &bus[k * numFrames], numFrames * sizeof(float));
+        if (dumpFile) {
+            writeRecord(sentMidi.data(), (uint32_t)sentMidi.size());
+            writeRecord(bus.data(), (uint32_t)(bus.size() * sizeof(float)));
+        }
+        if (compareFile) compareBlock(cmp, b, bus.data(), numFrames);
+        if (b % 50 == 0) factory->draw(alg);
+    }
+
+    // The preset the run ends with is part of its output
+    std::string preset = serialise(factory, alg);
+    hashBytes(STREAM_PRESET, preset.data(), preset.size());
+    if (dumpFile) writeRecord(preset.data(), (uint32_t)preset.size());
+    if (compareFile && !compareRecord(cmp, preset.data(), (uint32_t)preset.size()))
+        compareFailed(cmp, "saved preset %s, expected %.*s", preset.c_str(), (int)cmp.record.size(),
+                      (const char*)cmp.record.data());
+    if (cmp.differs) return false;
+
+#ifdef STRUMMER_PROFILE
+    // Profiling must count every block without changing the output (checked above)
+    const ProfileStats& prof = *profileStats(alg);
+    bool ok = prof.blocks == (uint32_t)sc.blocks && prof.totalFrames == (uint64_t)sc.blocks * numFrames &&
+              prof.minCycles <= prof.maxCycles && prof.worst[0].cycles == prof.maxCycles &&
+              prof.worst[0].frames == numFrames;
+    resetProfileStats(alg);
+    if (!ok || profileStats(alg)->blocks != 0) {
+        fprintf(stderr, "%s: profile counted %u blocks, %llu frames\n", sc.name, prof.blocks,
+                (unsigned long long)prof.totalFrames);
+        return false;
+    }
+#endif
+
+    check.name = sc.name;
+    for (int k = 0; k < NUM_STREAMS; ++k) {
+        std::string label = (k == STREAM_MIDI) ? "MIDI" : (k == STREAM_PRESET) ? "preset" : "bus " + std::to_string(k + 1);
+        check.add(label, (streamHash[k] ^ (streamHash[k] >> 32)) & 0xFFFFFFFFu, true);
+        check.values.back().erase(0, 8);  // 32 bits per stream keeps the lines short
+    }
+    return true;
+}
+
+// Memory asked for at each lane count. The DTC share is also capped at compile time
+// (STATE_DTC_BUDGET / LANE_DTC_BUDGET); this pins the actual figures, so growth is deliberate.
+static void footprintChecks(const _NT_factory* factory, std::vector<Check>& checks) {
+    for (int lanes = factory->specifications[0].min; lanes <= factory->specifications[0].max; ++lanes) {
+        int32_t specs[1] = { lanes };
+        _NT_algorithmRequirements req;
+        memset(&req, 0, sizeof(req));
+        factory->calculateRequirements(req, specs);
+        Check check;
+        check.name = "footprint-" + std::to_string(lanes) + "-lanes";
+        check.add("parameters", req.numParameters, false);
+        check.add("SRAM", req.sram, false);
+        check.add("DRAM", req.dram, false);
+        check.add("DTC", req.dtc, false);
+        check.add("ITC", req.itc, false);
+        checks.push_back(check);
+    }
+}
+
+// --- Benchmark ---
+// Wall-clock cost of step() per sample across block sizes, standard and exotic scales, string
+// counts, envelope shapes and trigger rates. Each configuration runs on a fresh instance and
+// is timed after a short warm-up; the input busses are refilled every block, as on hardware.
+#define BENCH_RATE 48000
+#define BENCH_SECONDS 0.25f
+
+static const int benchFramesBy4[] = { 1, 4, 8, 16, 32 };
+static const char* benchScales[] = { "Major", "Min Pent", "Gamelan", "Pythagorean", "1/4-E" };
+static const char* benchEnvShapes[] = { "Linear", "Simple Exp", "Classic Exp" };
+
+struct BenchTriggers {
+    const char* name;
+    int period;                         // Frames between Trig UP pulses; Trig Down falls in between
+};
+
+static const BenchTriggers benchTriggers[] = {
+    { "light", BENCH_RATE / 2 },        // A strum every 500 ms
+    { "dense", BENCH_RATE / 50 },       // Every 20 ms, each overlapping the last
+};
+
+static int runBench(const _NT_factory* factory) {
+    testGlobals.sampleRate = BENCH_RATE;
+    printf("frames_per_block,scale,strings,env_shape,triggers,ns_per_sample\n");
+    for (size_t f = 0; f < sizeof(benchFramesBy4) / sizeof(benchFramesBy4[0]); ++f)
+    for (size_t sc = 0; sc < sizeof(benchScales) / sizeof(benchScales[0]); ++sc)
+    for (int strings = 1; strings <= 20; ++strings)
+    for (int shape = 0; shape < 3; ++shape)
+    for (size_t t = 0; t < sizeof(benchTriggers) / sizeof(benchTriggers[0]); ++t) {
+        int framesBy4 = benchFramesBy4[f];
+        int numFrames = framesBy4 * 4;
+        testGlobals.maxFramesPerStep = numFrames;
+        Instance inst;
+        construct(factory, 1, inst);
+        int numParameters = (int)inst.values.size();
+        int scaleParam = findParameter(inst.alg, numParameters, "Scale");
+        if (scaleParam < 0) return 2;
+        Setting scale = { "Scale", enumIndex(inst.alg->parameters[scaleParam], benchScales[sc]) };
+        Setting settings[] = { scale, { "Strings", strings }, { "Env Shape", shape }, { "Spacing ms", 10 } };
+        if (scale.value < 0) {
+            fprintf(stderr, "unknown scale \"%s\"\n", benchScales[sc]);
+            return 2;
+        }
+        for (size_t k = 0; k < sizeof(settings) / sizeof(settings[0]); ++k)
+            if (!applySetting(factory, inst, settings[k])) return 2;
+
+        // Pulses 1 ms wide, so every one is a fresh edge
+        int blocks = (int)(BENCH_SECONDS * BENCH_RATE) / numFrames;
+        int warmup = blocks / 10;
+        int period = benchTriggers[t].period;
+        std::vector<float> inputs(2 * (size_t)(blocks + warmup) * numFrames);
+        for (size_t i = 0; i < inputs.size() / 2; ++i) {
+            inputs[2 * i] = ((int)(i % period) < BENCH_RATE / 1000) ? 5.0f : 0.0f;
+            inputs[2 * i + 1] = ((int)((i + period / 2) % period) < BENCH_RATE / 1000) ? 5.0f : 0.0f;
+        }
+        std::vector<float> bus(NUM_BUSSES * numFrames, 0.0f);
+        std::chrono::steady_clock::time_point start;
+        for (int b = 0; b < warmup + blocks; ++b) {
+            if (b == warmup) start = std::chrono::steady_clock::now();
+            const float* in = &inputs[2 * (size_t)b * numFrames];
+            for (int i = 0; i < numFrames; ++i) {
+                bus[i] = in[2 * i];
+                bus[numFrames + i] = in[2 * i + 1];
+            }
+            factory->step(inst.alg, bus.data(), framesBy4);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("%d,%s,%d,%s,%s,%.2f\n", numFrames, benchScales[sc], strings, benchEnvShapes[shape], benchTriggers[t].name,
+               ns / ((double)blocks * numFrames));
+    }
+    return 0;
+}
+
+// --- Golden file ---
+static bool readGolden(const char* path, std::vector<std::string>& lines) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        lines.push_back(line);
+    }
+    fclose(f);
+    return true;
+}
+
+// Lists the values of check that differ from its golden line
+static bool matchGolden(const Check& check, const std::vector<std::string>& golden) {
+    std::string line = check.line();
+    for (size_t g = 0; g < golden.size(); ++g) {
+        if (golden[g].compare(0, check.name.size() + 1, check.name + " ")) continue;
+        if (golden[g] == line) return true;
+        std::string differs;
+        size_t pos = check.name.size() + 1;
+        for (size_t k = 0; k < check.values.size(); ++k) {
+            size_t end = golden[g].find(' ', pos);
+            std::string expected = golden[g].substr(pos, (end == std::string::npos) ? end : end - pos);
+            if (expected != check.values[k]) differs += (differs.empty() ? "" : ", ") + check.labels[k];
+            pos = (end == std::string::npos) ? golden[g].size() : end + 1;
+        }
+        printf("FAIL %s: %s differ%s\n", check.name.c_str(), differs.empty() ? "field counts" : differs.c_str(),
+               (differs.find(',') == std::string::npos && !differs.empty()) ? "s" : "");
+        return false;
+    }
+    printf("FAIL %s: not in the golden file\n", check.name.c_str());
+    return false;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && !strcmp(argv[1], "--bench"))
+        return runBench((const _NT_factory*)pluginEntry(kNT_selector_factoryInfo, 0));
+    const char* mode = (argc == 3) ? argv[1] : "";
+    if (!(argc == 2 || (argc == 3 && (!strcmp(mode, "--update") || !strcmp(mode, "--dump") ||
+                                       !strcmp(mode, "--compare"))))) {
+        fprintf(stderr, "usage: %s [--update | --dump | --compare] FILE, or %s --bench\n", argv[0], argv[0]);
+        return 2;
+    }
+    const char* path = argv[argc - 1];
+    bool update = !strcmp(mode, "--update");
+    bool useGolden = (argc == 2);
+    if (!strcmp(mode, "--dump")) dumpFile = strcmp(path, "-") ? fopen(path, "wb") : stdout;
+    if (!strcmp(mode, "--compare")) compareFile = strcmp(path, "-") ? fopen(path, "rb") : stdin;
+    if ((!strcmp(mode, "--dump") && !dumpFile) || (!strcmp(mode, "--compare") && !compareFile)) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 2;
+    }
+    std::vector<std::string> golden;
+    if (useGolden && !readGolden(path, golden)) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 2;
+    }
+
+    const _NT_factory* factory = (const _NT_factory*)pluginEntry(kNT_selector_factoryInfo, 0);
+    std::vector<Check> checks;
+    footprintChecks(factory, checks);
+    int numScenarios = (int)(sizeof(scenarios) / sizeof(scenarios[0]));
+    int failures = 0;
+    for (int s = 0; s < numScenarios; ++s) {
+        Check check;
+        if (runScenario(factory, scenarios[s], check)) checks.push_back(check);
+        else ++failures;
+    }
+    if (dumpFile) {
+        if (dumpFile != stdout) fclose(dumpFile);
+        return failures ? 1 : 0;
+    }
+    if (compareFile) {
+        printf("%d/%d scenarios match the dump\n", numScenarios - failures, numScenarios);
+        return failures ? 1 : 0;
+    }
+
+    if (update) {
+        if (failures) return 1;
+        FILE* f = fopen(path, "w");
+        if (!f) return 2;
+        for (size_t k = 0; k < checks.size(); ++k) fprintf(f, "%s\n", checks[k].line().c_str());
+        fclose(f);
+        printf("wrote %d checks to %s\n", (int)checks.size(), path);
+        return 0;
+    }
+    int total = (int)checks.size() + failures; // Scenarios that did not run count as failed
+    for (size_t k = 0; k < checks.size(); ++k) failures += !matchGolden(checks[k], golden);
+    printf("%d/%d checks match %s\n", total - failures, total, path);
+    if (failures) printf("(make -C tests diff REF=<good revision> shows the first differing frame)\n");
+    return failures ? 1 : 0;
+}
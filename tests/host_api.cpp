@@ -0,0 +1,194 @@
+// API functions the plugin calls and the instance helpers declared in host_api.h. The JSON
+// state and the MIDI log are per thread, so a host can run instances on several threads.
+#include "host_api.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- API functions the plugin calls ---
+uint8_t NT_screen[128 * 64];
+
+void NT_drawText(int, int, const char*, int, _NT_textAlignment, _NT_textSize) {}
+void NT_drawShapeI(_NT_shape, int, int, int, int, int) {}
+int NT_intToString(char* buffer, int32_t value) { return sprintf(buffer, "%d", (int)value); }
+int NT_floatToString(char* buffer, float value, int decimalPlaces) { return sprintf(buffer, "%.*f", decimalPlaces, value); }
+int32_t NT_algorithmIndex(const _NT_algorithm*) { return 0; }
+void NT_updateParameterDefinition(uint32_t, uint32_t) {}
+void NT_setParameterFromAudio(uint32_t, uint32_t, int16_t) {}
+
+thread_local std::vector<uint8_t> sentMidi;
+
+void NT_sendMidi3ByteMessage(uint32_t destination, uint8_t b0, uint8_t b1, uint8_t b2) {
+    uint8_t message[4] = { (uint8_t)destination, b0, b1, b2 };
+    sentMidi.insert(sentMidi.end(), message, message + 4);
+}
+
+// --- JSON stream and parser ---
+// Just enough of the host's preset JSON for serialise()/deserialise(): the stream writes
+// compact text, the parser walks a string in place the way the host's parser is driven.
+static thread_local std::string jsonOut;
+static thread_local bool jsonComma = false;
+
+static void jsonValue() { if (jsonComma) jsonOut += ','; jsonComma = true; }
+
+void _NT_jsonStream::openArray() { jsonValue(); jsonOut += '['; jsonComma = false; }
+void _NT_jsonStream::closeArray() { jsonOut += ']'; jsonComma = true; }
+void _NT_jsonStream::openObject() { jsonValue(); jsonOut += '{'; jsonComma = false; }
+void _NT_jsonStream::closeObject() { jsonOut += '}'; jsonComma = true; }
+void _NT_jsonStream::addMemberName(const char* name) { jsonValue(); jsonOut += '"'; jsonOut += name; jsonOut += "\":"; jsonComma = false; }
+void _NT_jsonStream::addNumber(int value) { jsonValue(); jsonOut += std::to_string(value); }
+void _NT_jsonStream::addNumber(float value) { jsonValue(); char s[32]; snprintf(s, sizeof(s), "%.9g", value); jsonOut += s; }
+void _NT_jsonStream::addFourCC(uint32_t fourcc) { addNumber((int)fourcc); }
+void _NT_jsonStream::addBoolean(bool value) { jsonValue(); jsonOut += value ? "true" : "false"; }
+void _NT_jsonStream::addNull() { jsonValue(); jsonOut += "null"; }
+void _NT_jsonStream::addString(const char* str) {
+    jsonValue();
+    jsonOut += '"';
+    for (; *str; ++str) {
+        if (*str == '\n') jsonOut += "\\n";
+        else if (*str == '"' || *str == '\\') { jsonOut += '\\'; jsonOut += *str; }
+        else jsonOut += *str;
+    }
+    jsonOut += '"';
+}
+
+static thread_local const char* jsonIn;
+static thread_local std::string jsonString;
+
+// Skips whitespace and the separators/closers between values
+static void jsonSkip() { while (*jsonIn && strchr(" \t\r\n,:]}", *jsonIn)) ++jsonIn; }
+
+static bool jsonReadString() {
+    jsonSkip();
+    if (*jsonIn != '"') return false;
+    jsonString.clear();
+    for (++jsonIn; *jsonIn && *jsonIn != '"'; ++jsonIn) {
+        if (*jsonIn == '\\' && jsonIn[1]) jsonString += (*++jsonIn == 'n') ? '\n' : *jsonIn;
+        else jsonString += *jsonIn;
+    }
+    if (*jsonIn) ++jsonIn;
+    return true;
+}
+
+// Skips one value of any kind
+static void jsonSkipValue() {
+    jsonSkip();
+    if (*jsonIn == '"') { jsonReadString(); return; }
+    if (*jsonIn != '{' && *jsonIn != '[') {
+        while (*jsonIn && !strchr(",]} \t\r\n", *jsonIn)) ++jsonIn;
+        return;
+    }
+    int depth = 0;
+    for (; *jsonIn; ++jsonIn) {
+        if (*jsonIn == '"') { jsonReadString(); --jsonIn; continue; }
+        if (*jsonIn == '{' || *jsonIn == '[') ++depth;
+        else if ((*jsonIn == '}' || *jsonIn == ']') && --depth == 0) { ++jsonIn; return; }
+    }
+}
+
+// Counts the values of the container at jsonIn and steps inside it
+static bool jsonOpen(char open, int& count) {
+    jsonSkip();
+    if (*jsonIn != open) return false;
+    const char* start = ++jsonIn;
+    count = 0;
+    for (;;) {
+        while (*jsonIn && strchr(" \t\r\n,", *jsonIn)) ++jsonIn;
+        if (!*jsonIn || *jsonIn == ']' || *jsonIn == '}') break;
+        if (open == '{' && !jsonReadString()) return false;
+        jsonSkipValue();
+        ++count;
+    }
+    jsonIn = start;
+    return true;
+}
+
+bool _NT_jsonParse::numberOfObjectMembers(int& num) { return jsonOpen('{', num); }
+bool _NT_jsonParse::numberOfArrayElements(int& num) { return jsonOpen('[', num); }
+bool _NT_jsonParse::skipMember() { if (!jsonReadString()) return false; jsonSkipValue(); return true; }
+bool _NT_jsonParse::string(const char*& str) { if (!jsonReadString()) return false; str = jsonString.c_str(); return true; }
+
+bool _NT_jsonParse::matchName(const char* name) {
+    const char* save = jsonIn;
+    if (jsonReadString() && jsonString == name) return true;
+    jsonIn = save;
+    return false;
+}
+
+bool _NT_jsonParse::number(int& value) {
+    jsonSkip();
+    char* end;
+    value = (int)strtol(jsonIn, &end, 10);
+    if (end == jsonIn) return false;
+    jsonIn = end;
+    return true;
+}
+
+bool _NT_jsonParse::number(float& value) {
+    jsonSkip();
+    char* end;
+    value = strtof(jsonIn, &end);
+    if (end == jsonIn) return false;
+    jsonIn = end;
+    return true;
+}
+
+bool _NT_jsonParse::boolean(bool& value) {
+    jsonSkip();
+    value = (*jsonIn == 't');
+    jsonSkipValue();
+    return true;
+}
+
+// --- Instances ---
+void construct(const _NT_factory* factory, int lanes, Instance& inst) {
+    int32_t specs[1] = { lanes };
+    _NT_algorithmRequirements req;
+    memset(&req, 0, sizeof(req));
+    factory->calculateRequirements(req, specs);
+    inst.sram.assign(req.sram + 16, 0);
+    inst.dram.assign(req.dram + 16, 0);
+    inst.dtc.assign(req.dtc + 16, 0);
+    inst.itc.assign(req.itc + 16, 0);
+    _NT_algorithmMemoryPtrs ptrs = { inst.sram.data(), inst.dram.data(), inst.dtc.data(), inst.itc.data() };
+    inst.alg = factory->construct(ptrs, req, specs);
+    inst.values.resize(req.numParameters);
+    for (uint32_t p = 0; p < req.numParameters; ++p) inst.values[p] = inst.alg->parameters[p].def;
+    inst.alg->v = inst.alg->vIncludingCommon = inst.values.data();
+    for (uint32_t p = 0; p < req.numParameters; ++p) factory->parameterChanged(inst.alg, p);
+}
+
+bool deserialise(const _NT_factory* factory, _NT_algorithm* alg, const char* json) {
+    _NT_jsonParse parse;
+    jsonIn = json;
+    return factory->deserialise(alg, parse);
+}
+
+std::string serialise(const _NT_factory* factory, _NT_algorithm* alg) {
+    _NT_jsonStream stream;
+    jsonOut.clear();
+    jsonComma = false;
+    stream.openObject();
+    factory->serialise(alg, stream);
+    stream.closeObject();
+    return jsonOut;
+}
+
+int findParameter(const _NT_algorithm* alg, int numParameters, const char* name) {
+    for (int p = 0; p < numParameters; ++p)
+        if (!strcmp(alg->parameters[p].name, name)) return p;
+    fprintf(stderr, "unknown parameter \"%s\"\n", name);
+    return -1;
+}
+
+int enumIndex(const _NT_parameter& param, const char* name) {
+    for (int k = 0; param.enumStrings && param.enumStrings[k]; ++k)
+        if (!strcmp(param.enumStrings[k], name)) return k;
+    return -1;
+}
+
+void setParameter(const _NT_factory* factory, Instance& inst, int p, int value) {
+    const _NT_parameter& param = inst.alg->parameters[p];
+    inst.values[p] = (int16_t)((value < param.min) ? param.min : (value > param.max) ? param.max : value);
+    factory->parameterChanged(inst.alg, p);
+}
@@ -0,0 +1,35 @@
+// What the desktop hosts (host.cpp, render.cpp) share: the API functions the plugin calls
+// live in host_api.cpp, and these helpers load and drive one instance through its factory.
+// Everything here may be used from several threads, one instance per thread.
+#pragma once
+
+#include <distingnt/api.h>
+#include <string>
+#include <vector>
+
+#define NUM_BUSSES 28
+
+extern _NT_globals& testGlobals;        // globals.cpp: the writable NT_globals
+uintptr_t pluginEntry(_NT_selector selector, uint32_t data);
+
+// MIDI messages sent by this thread since it last cleared them, 4 bytes each
+// (destination, status, data 1, data 2)
+extern thread_local std::vector<uint8_t> sentMidi;
+
+struct Instance {
+    std::vector<uint8_t> sram, dram, dtc, itc;
+    std::vector<int16_t> values;
+    _NT_algorithm* alg;
+};
+
+// Constructs an instance with every parameter at its default, as the host does
+void construct(const _NT_factory* factory, int lanes, Instance& inst);
+bool deserialise(const _NT_factory* factory, _NT_algorithm* alg, const char* json);
+std::string serialise(const _NT_factory* factory, _NT_algorithm* alg);
+
+// Index of the parameter called name, or -1 (reported on stderr)
+int findParameter(const _NT_algorithm* alg, int numParameters, const char* name);
+// Index of name in an enum parameter's strings, or -1
+int enumIndex(const _NT_parameter& param, const char* name);
+// Sets parameter p, clamped to its current range, and tells the plugin
+void setParameter(const _NT_factory* factory, Instance& inst, int p, int value);
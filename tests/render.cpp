@@ -0,0 +1,340 @@
+// Offline renderer for Strummer.
+//
+// Loads the plugin through pluginEntry like the distingNT does and renders a job file: one
+// instance per job, run on every core by a work-stealing pool, each writing chosen busses to
+// a WAV (32-bit float) or raw (interleaved float32) file. Jobs differ a lot in length, so the
+// pool deals them out evenly and an idle worker takes work from the front of a busy one's queue.
+//
+//   strummer_render [-j THREADS] [-r RATE] [-b FRAMES] [-o DIR] JOBFILE
+//
+// One job per line, '#' starts a comment:
+//
+//   OUTPUT SECONDS [key=value ...]
+//
+// OUTPUT ends in .wav or .raw and is written under DIR. Keys are parameter names, quoted when
+// they contain spaces ("Env Shape"="Classic Exp"); enum values may be given by name. These
+// keys set up the job itself rather than a parameter:
+//
+//   lanes=N          lane count (default 1)
+//   preset=FILE      preset JSON to load before the settings, e.g. for Scala tunings; a
+//                    relative path is taken from the job file's directory
+//   up=MS, down=MS   period of the 1 ms pulses on every lane's Trig UP and Trig Down input
+//                    (busses 1 and 2, 3 and 4, ...; 0 = none, default up=500 down=0); Trig
+//                    Down starts half its period in, so the two alternate
+//   busses=LIST      busses to write, as channels in this order (default 13-20)
+//
+// The sample rate and block size are the same for every job, as NT_globals is shared.
+
+#include "host_api.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define MAX_FRAMES_PER_BLOCK 128
+
+struct Job {
+    int line;                           // In the job file, for messages
+    std::string output;
+    float seconds = 0.0f;
+    int lanes = 1;
+    float upMs = 500.0f, downMs = 0.0f;
+    std::string preset;
+    std::vector<int> busses;            // 0-based
+    std::vector<std::pair<std::string, std::string> > settings;
+};
+
+static int sampleRate = 48000;
+static int framesPerBlock = 32;
+static std::string outputDir = ".";
+static std::string jobDir = ".";
+
+// --- Job file ---
+// Splits a line at spaces outside double quotes; quotes are removed
+static std::vector<std::string> splitLine(const std::string& line) {
+    std::vector<std::string> words;
+    std::string word;
+    bool quoted = false, any = false;
+    for (size_t i = 0; i <= line.size(); ++i) {
+        char c = (i < line.size()) ? line[i] : ' ';
+        if (c == '#' && !quoted) c = ' ', i = line.size();
+        if (c == '"') { quoted = !quoted; any = true; continue; }
+        if ((c == ' ' || c == '\t' || c == '\r') && !quoted) {
+            if (any) words.push_back(word);
+            word.clear();
+            any = false;
+            continue;
+        }
+        word += c;
+        any = true;
+    }
+    return words;
+}
+
+// "13-20" or "13,15,21-24"
+static bool parseBusses(const std::string& text, std::vector<int>& busses) {
+    busses.clear();
+    const char* p = text.c_str();
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10), last = first;
+        if (end == p) return false;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p) return false;
+        }
+        if (first < 1 || last > NUM_BUSSES || first > last) return false;
+        for (long b = first; b <= last; ++b) busses.push_back((int)b - 1);
+        p = (*end == ',') ? end + 1 : end;
+        if (*end && *end != ',') return false;
+    }
+    return !busses.empty();
+}
+
+static bool parseJob(const std::vector<std::string>& words, Job& job) {
+    if (words.size() < 2) return false;
+    job.output = words[0];
+    job.seconds = strtof(words[1].c_str(), NULL);
+    size_t ext = job.output.rfind('.');
+    std::string type = (ext == std::string::npos) ? "" : job.output.substr(ext);
+    if (job.seconds <= 0.0f || (type != ".wav" && type != ".raw")) return false;
+    parseBusses("13-20", job.busses);
+    for (size_t w = 2; w < words.size(); ++w) {
+        size_t eq = words[w].find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = words[w].substr(0, eq), value = words[w].substr(eq + 1);
+        if (key == "lanes") job.lanes = atoi(value.c_str());
+        else if (key == "preset") job.preset = value;
+        else if (key == "up") job.upMs = strtof(value.c_str(), NULL);
+        else if (key == "down") job.downMs = strtof(value.c_str(), NULL);
+        else if (key == "busses") { if (!parseBusses(value, job.busses)) return false; }
+        else job.settings.push_back(std::make_pair(key, value));
+    }
+    return true;
+}
+
+static bool readJobs(const char* path, std::vector<Job>& jobs) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return false;
+    }
+    char text[4096];
+    bool ok = true;
+    for (int line = 1; fgets(text, sizeof(text), f); ++line) {
+        std::vector<std::string> words = splitLine(std::string(text, strcspn(text, "\n")));
+        if (words.empty()) continue;
+        Job job;
+        job.line = line;
+        if (parseJob(words, job)) jobs.push_back(job);
+        else {
+            fprintf(stderr, "%s:%d: not a job\n", path, line);
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+static bool readFile(const std::string& path, std::string& text) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buffer[4096];
+    size_t n;
+    text.clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) text.append(buffer, n);
+    fclose(f);
+    return true;
+}
+
+// --- Output files ---
+static void put16(FILE* f, uint16_t v) { uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; fwrite(b, 1, 2, f); }
+static void put32(FILE* f, uint32_t v) { put16(f, (uint16_t)v); put16(f, (uint16_t)(v >> 16)); }
+
+// WAVE_FORMAT_IEEE_FLOAT, with the fact chunk non-PCM formats carry
+static void writeWavHeader(FILE* f, int channels, uint32_t frames) {
+    uint32_t dataBytes = frames * channels * 4;
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 4 + 26 + 12 + 8 + dataBytes);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 18);
+    put16(f, 3);
+    put16(f, (uint16_t)channels);
+    put32(f, (uint32_t)sampleRate);
+    put32(f, (uint32_t)sampleRate * channels * 4);
+    put16(f, (uint16_t)(channels * 4));
+    put16(f, 32);
+    put16(f, 0);
+    fwrite("fact", 1, 4, f);
+    put32(f, 4);
+    put32(f, frames);
+    fwrite("data", 1, 4, f);
+    put32(f, dataBytes);
+}
+
+// --- Rendering ---
+static bool applyJobSetting(const _NT_factory* factory, Instance& inst, const Job& job,
+                            const std::string& name, const std::string& value) {
+    int p = findParameter(inst.alg, (int)inst.values.size(), name.c_str());
+    if (p < 0) return false;
+    char* end;
+    long v = strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end) {
+        v = enumIndex(inst.alg->parameters[p], value.c_str());
+        if (v < 0) {
+            fprintf(stderr, "line %d: \"%s\" has no value \"%s\"\n", job.line, name.c_str(), value.c_str());
+            return false;
+        }
+    }
+    setParameter(factory, inst, p, (int)v);
+    return true;
+}
+
+// Renders one job; the output only depends on the job, not on the thread or the other jobs
+static bool renderJob(const _NT_factory* factory, const Job& job) {
+    if (job.lanes < factory->specifications[0].min || job.lanes > factory->specifications[0].max) {
+        fprintf(stderr, "line %d: lanes must be %d to %d\n", job.line, factory->specifications[0].min,
+                factory->specifications[0].max);
+        return false;
+    }
+    Instance inst;
+    construct(factory, job.lanes, inst);
+    if (!job.preset.empty()) {
+        std::string json;
+        std::string path = (job.preset[0] == '/') ? job.preset : jobDir + "/" + job.preset;
+        if (!readFile(path, json)) {
+            fprintf(stderr, "line %d: cannot read %s\n", job.line, job.preset.c_str());
+            return false;
+        }
+        if (!deserialise(factory, inst.alg, json.c_str())) {
+            fprintf(stderr, "line %d: %s is not a Strummer preset\n", job.line, job.preset.c_str());
+            return false;
+        }
+    }
+    for (size_t s = 0; s < job.settings.size(); ++s)
+        if (!applyJobSetting(factory, inst, job, job.settings[s].first, job.settings[s].second)) return false;
+
+    std::string path = outputDir + "/" + job.output;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "line %d: cannot write %s\n", job.line, path.c_str());
+        return false;
+    }
+    int channels = (int)job.busses.size();
+    uint32_t frames = (uint32_t)(job.seconds * sampleRate + 0.5f);
+    bool wav = job.output.compare(job.output.size() - 4, 4, ".wav") == 0;
+    if (wav) writeWavHeader(f, channels, frames);
+
+    int pulse = sampleRate / 1000;
+    int upPeriod = (int)(job.upMs * sampleRate / 1000.0f), downPeriod = (int)(job.downMs * sampleRate / 1000.0f);
+    std::vector<float> bus(NUM_BUSSES * framesPerBlock);
+    std::vector<float> out(channels * framesPerBlock);
+    for (uint32_t done = 0; done < frames; done += framesPerBlock) {
+        for (int i = 0; i < framesPerBlock; ++i) {
+            uint32_t t = done + i;
+            float up = (upPeriod > 0 && (int)(t % upPeriod) < pulse) ? 5.0f : 0.0f;
+            float down = (downPeriod > 0 && (int)((t + downPeriod - downPeriod / 2) % downPeriod) < pulse) ? 5.0f : 0.0f;
+            for (int l = 0; l < job.lanes; ++l) {
+                bus[(2 * l) * framesPerBlock + i] = up;
+                bus[(2 * l + 1) * framesPerBlock + i] = down;
+            }
+        }
+        sentMidi.clear();
+        factory->step(inst.alg, bus.data(), framesPerBlock / 4);
+        int n = (frames - done < (uint32_t)framesPerBlock) ? (int)(frames - done) : framesPerBlock;
+        for (int i = 0; i < n; ++i)
+            for (int c = 0; c < channels; ++c) out[i * channels + c] = bus[job.busses[c] * framesPerBlock + i];
+        fwrite(out.data(), sizeof(float), n * channels, f);
+    }
+    bool ok = !ferror(f);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) fprintf(stderr, "line %d: error writing %s\n", job.line, path.c_str());
+    return ok;
+}
+
+// --- Work-stealing pool ---
+// Each worker owns a queue of job indices. It takes from the back of its own and, once that
+// is empty, steals from the front of the others'.
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<int> jobs;
+};
+
+static bool takeJob(std::vector<WorkQueue>& queues, int self, int& job) {
+    {
+        std::lock_guard<std::mutex> guard(queues[self].lock);
+        if (!queues[self].jobs.empty()) {
+            job = queues[self].jobs.back();
+            queues[self].jobs.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues.size(); ++k) {
+        WorkQueue& victim = queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.jobs.empty()) continue;
+        job = victim.jobs.front();
+        victim.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+static void worker(const _NT_factory* factory, const std::vector<Job>& jobs, std::vector<WorkQueue>& queues,
+                   int self, std::vector<char>& ok) {
+    int job;
+    while (takeJob(queues, self, job)) ok[job] = renderJob(factory, jobs[job]);
+}
+
+int main(int argc, char** argv) {
+    int threads = (int)std::thread::hardware_concurrency();
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        if (!strcmp(argv[arg], "-j")) threads = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-r")) sampleRate = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-b")) framesPerBlock = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-o")) outputDir = argv[arg + 1];
+        else break;
+    }
+    if (arg + 1 != argc || sampleRate < 1000 || framesPerBlock < 4 || framesPerBlock > MAX_FRAMES_PER_BLOCK ||
+        framesPerBlock % 4) {
+        fprintf(stderr, "usage: %s [-j THREADS] [-r RATE] [-b FRAMES (4-128, by 4)] [-o DIR] JOBFILE\n", argv[0]);
+        return 2;
+    }
+    std::vector<Job> jobs;
+    if (!readJobs(argv[arg], jobs)) return 2;
+    const char* slash = strrchr(argv[arg], '/');
+    if (slash) jobDir.assign(argv[arg], slash - argv[arg]);
+    if (threads > (int)jobs.size()) threads = (int)jobs.size();
+    if (threads < 1) threads = 1;
+
+    // NT_globals is read by every instance, so it is set once before any thread starts
+    testGlobals.sampleRate = (uint32_t)sampleRate;
+    testGlobals.maxFramesPerStep = (uint32_t)framesPerBlock;
+    const _NT_factory* factory = (const _NT_factory*)pluginEntry(kNT_selector_factoryInfo, 0);
+
+    std::vector<WorkQueue> queues(threads);
+    for (size_t j = 0; j < jobs.size(); ++j) queues[j % threads].jobs.push_back((int)j);
+    std::vector<char> ok(jobs.size(), 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.push_back(std::thread(worker, factory, std::cref(jobs), std::ref(queues), t, std::ref(ok)));
+    for (size_t t = 0; t < pool.size(); ++t) pool[t].join();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double audio = 0.0;
+    int failures = 0;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        audio += jobs[j].seconds;
+        failures += !ok[j];
+    }
+    printf("rendered %d/%d jobs, %.1f s of output in %.2f s on %d thread%s (%.0fx real time)\n",
+           (int)jobs.size() - failures, (int)jobs.size(), audio, wall, threads, (threads == 1) ? "" : "s", (wall > 0.0) ? audio / wall : 0.0);
+    return failures ? 1 : 0;
+}